@@ -1,186 +1,711 @@
-﻿#include <iostream>
-#include <string>
-#include <cstdlib> // Для rand() и srand()
-#include <ctime>   // Для time()
-
-class Entity {
-protected:
-    std::string name;
-    int health;
-    int attackPower;
-    int defense;
-
-public:
-    Entity(const std::string& n, int h, int a, int d)
-        : name(n), health(h), attackPower(a), defense(d) {
-    }
-
-    std::string getName() const {
-        return name;
-    }
-
-    int getHealth() const { return health; }
-    int getDefense() const { return defense; } 
-    void reduceHealth(int amount) { health -= amount; }
-
-    // Виртуальный метод для атаки
-    virtual void attack(Entity& target) {
-        int damage = attackPower - target.getDefense();
-        if (damage > 0) {
-            target.reduceHealth(damage);
-            std::cout << name << " attacks " << target.getName() << " for " << damage << " damage!\n";
-        }
-        else {
-            std::cout << name << " attacks " << target.getName() << ", but it has no effect!\n";
-        }
-    }
-
-    // Виртуальный метод для вывода информации
-    virtual void displayInfo() const {
-        std::cout << "Name: " << name << ", HP: " << health
-            << ", Attack: " << attackPower << ", Defense: " << defense << std::endl;
-    }
-
-    virtual void heal(int amount) {
-        if (amount > 0) {
-            health += amount;
-            std::cout << name << " восстанавливает " << amount << " HP!\n";
-        }
-    }
-
-    // Виртуальный деструктор
-    virtual ~Entity() {}
-};
-
-class Character : public Entity {
-public:
-    Character(const std::string& n, int h, int a, int d)
-        : Entity(n, h, a, d) {
-    }
-
-    // Переопределение метода attack
-    void attack(Entity& target) override {
-        int damage = attackPower - target.getDefense();
-        if (damage > 0) {
-            // Шанс на критический удар (20%)
-            if (rand() % 100 < 20) {
-                damage *= 2;
-                std::cout << "Critical hit! ";
-            }
-            target.reduceHealth(damage);
-            std::cout << name << " attacks " << target.getName() << " for " << damage << " damage!\n";
-        }
-        else {
-            std::cout << name << " attacks " << target.getName() << ", but it has no effect!\n";
-        }
-    }
-
-    // Переопределение метода displayInfo
-    void displayInfo() const override {
-        std::cout << "Character: " << name << ", HP: " << health
-            << ", Attack: " << attackPower << ", Defense: " << defense << std::endl;
-    }
-    // Переопределение метода heal с ограничением максимального здоровья
-    void heal(int amount) override {
-        if (amount > 0) {
-            int oldHealth = health;
-            health += amount;
-            if (health > 100) { // Предположим, что максимум HP для персонажа = 100
-                health = 100;
-            }
-            std::cout << name << " восстанавливает " << (health - oldHealth) << " HP!\n";
-        }
-    }
-};
-
-class Monster : public Entity {
-public:
-    Monster(const std::string& n, int h, int a, int d)
-        : Entity(n, h, a, d) {
-    }
-
-    // Переопределение метода attack
-    void attack(Entity& target) override {
-        int damage = attackPower - target.getDefense();
-        if (damage > 0) {
-            // Шанс на ядовитую атаку (30%)
-            if (rand() % 100 < 30) {
-                damage += 5; // Дополнительный урон от яда
-                std::cout << "Poisonous attack! ";
-            }
-            target.reduceHealth(damage);
-            std::cout << name << " attacks " << target.getName() << " for " << damage << " damage!\n";
-        }
-        else {
-            std::cout << name << " attacks " << target.getName() << ", but it has no effect!\n";
-        }
-    }
-
-    // Переопределение метода displayInfo
-    void displayInfo() const override {
-        std::cout << "Monster: " << name << ", HP: " << health
-            << ", Attack: " << attackPower << ", Defense: " << defense << std::endl;
-    }
-};
-
-class Boss : public Monster {
-public:
-    Boss(const std::string& n, int h, int a, int d)
-        : Monster(n, h, a, d) {
-    }
-    void attack(Entity& target) override {
-        int damage = attackPower - target.getDefense();
-        if (damage > 0) {
-            // Шанс на огненный удар (40%)
-            if (rand() % 100 < 40) {
-                damage += 10; // Дополнительный урон от огня
-                std::cout << "Огненный удар! ";
-            }
-            target.reduceHealth(damage);
-            std::cout << name << " атакует " << target.getName() << " и наносит " << damage << " урона!\n";
-        }
-        else {
-            std::cout << name << " атакует " << target.getName() << ", но это не имеет эффекта!\n";
-        }
-    }
-    void displayInfo() const override {
-        std::cout << "Босс: " << name << ", HP: " << health
-            << ", Атака: " << attackPower << ", Защита: " << defense << std::endl;
-    }
-};
-
-
-int main() {
-    setlocale(LC_ALL, "ru");
-    srand(static_cast<unsigned>(time(0))); // Инициализация генератора случайных чисел
-
-    // Создание объектов
-    Character hero("Hero", 100, 20, 10);
-    Monster goblin("Goblin", 50, 15, 5);
-
-    Boss dragon("Дракон", 150, 25, 20);
-
-    // Массив указателей на базовый класс
-    Entity* entities[] = { &hero, &goblin, &dragon };
-
-    // Полиморфное поведение
-    for (auto* entity : entities) {
-        entity->displayInfo(); // Вывод информации о сущности
-    }
-
-    // Бой между персонажем и монстрами
-    hero.attack(goblin);
-    goblin.attack(hero);
-    dragon.attack(hero);
-
-    std::cout << "\nСостояние после атак:\n";
-    hero.displayInfo();
-    goblin.displayInfo();
-    dragon.displayInfo();
-
-    hero.heal(30);
-    std::cout << "Состояние после лечения:\n";
-    hero.displayInfo();
-
-    return 0;
+﻿#include <iostream>
+#include <string>
+#include <cstdlib> // Для rand() и srand()
+#include <ctime>   // Для time()
+#include <vector>
+#include <cstdint>
+#include <chrono>
+#include <random>
+#include <stdexcept>
+#include <utility>
+#include <thread>
+#include <algorithm>
+#include <memory>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define DAMAGE_SIMD_X86
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define AVX2_TARGET
+#else
+#define AVX2_TARGET __attribute__((target("avx2")))
+#endif
+#endif
+
+// Генератор xoshiro256**: быстрый, с явным зерном и без общего состояния.
+// Поток stream дает независимую последовательность для того же зерна,
+// например отдельную для каждого боя.
+class Xoshiro256 {
+private:
+    uint64_t s[4];
+
+    static uint64_t rotl(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+
+    // splitmix64 для заполнения состояния из зерна
+    static uint64_t splitmix(uint64_t& x) {
+        uint64_t z = (x += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+public:
+    using result_type = uint64_t;
+
+    explicit Xoshiro256(uint64_t seed, uint64_t stream = 0) {
+        uint64_t x = seed ^ (stream * 0xD1B54A32D192ED03ull);
+        for (auto& word : s) word = splitmix(x);
+    }
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return UINT64_MAX; }
+
+    result_type operator()() {
+        uint64_t result = rotl(s[1] * 5, 7) * 9;
+        uint64_t t = s[1] << 17;
+        s[2] ^= s[0];
+        s[3] ^= s[1];
+        s[1] ^= s[2];
+        s[0] ^= s[3];
+        s[2] ^= t;
+        s[3] = rotl(s[3], 45);
+        return result;
+    }
+
+    // Число из [0, n) умножением со сдвигом (смещение порядка n / 2^32)
+    int roll(int n) {
+        return static_cast<int>(((operator()() >> 32) * static_cast<uint64_t>(n)) >> 32);
+    }
+};
+
+// Генератор текущего потока для атак без явного генератора.
+// По умолчанию засевается случайно; seedThreadRng делает бой воспроизводимым.
+inline Xoshiro256& threadRng() {
+    thread_local Xoshiro256 rng(std::random_device{}());
+    return rng;
+}
+
+inline void seedThreadRng(uint64_t seed) {
+    threadRng() = Xoshiro256(seed);
+}
+
+// Бонус атаки: при броске 0..99 меньше chance урон умножается
+// на multiplier и увеличивается на bonus
+struct ProcRule {
+    int chance;
+    int multiplier;
+    int bonus;
+};
+
+// Бонусы, которые применяют методы attack() классов ниже
+constexpr ProcRule noProc{ 0, 1, 0 };
+constexpr ProcRule critProc{ 20, 2, 0 };   // Character: критический удар
+constexpr ProcRule poisonProc{ 30, 1, 5 }; // Monster: яд
+constexpr ProcRule fireProc{ 40, 1, 10 };  // Boss: огонь
+
+// Поштучный расчет одного удара: урон = атака - защита; если он не
+// положителен, удар не действует, иначе при броске меньше шанса бонуса
+// урон умножается на множитель и увеличивается на добавку
+inline int computeDamage(int attack, int defense, const ProcRule& rule, int roll) {
+    int damage = attack - defense;
+    if (damage <= 0) return 0;
+    if (roll < rule.chance) damage = damage * rule.multiplier + rule.bonus;
+    return damage;
+}
+
+// ===== События ударов =====
+// attack() записывает компактное событие; текст собирается только
+// потребителем, которому он нужен (например, выводом на консоль).
+
+// Сработавший бонус удара
+enum class AttackProc : uint8_t { None, Critical, Poison, Fire };
+
+// Язык сообщений атакующего
+enum class CombatLanguage : uint8_t { English, Russian };
+
+// Событие удара. Имена указывают на поля участников, поэтому участники
+// должны жить до flush журнала
+struct AttackEvent {
+    const std::string* attacker;
+    const std::string* target;
+    int32_t damage; // 0 - удар без эффекта
+    AttackProc proc;
+    CombatLanguage language;
+};
+
+// Потребитель пачек событий
+class CombatEventSink {
+public:
+    virtual ~CombatEventSink() = default;
+    virtual void consume(const std::vector<AttackEvent>& events) = 0;
+};
+
+// Вывод ударов в поток в прежнем текстовом виде
+class ConsoleCombatSink : public CombatEventSink {
+private:
+    std::ostream& out;
+public:
+    explicit ConsoleCombatSink(std::ostream& output = std::cout) : out(output) {}
+
+    void consume(const std::vector<AttackEvent>& events) override {
+        for (const auto& e : events) {
+            bool ru = e.language == CombatLanguage::Russian;
+            if (e.damage <= 0) {
+                out << *e.attacker << (ru ? " атакует " : " attacks ") << *e.target
+                    << (ru ? ", но это не имеет эффекта!\n" : ", but it has no effect!\n");
+                continue;
+            }
+            switch (e.proc) {
+            case AttackProc::Critical: out << "Critical hit! "; break;
+            case AttackProc::Poison: out << "Poisonous attack! "; break;
+            case AttackProc::Fire: out << "Огненный удар! "; break;
+            case AttackProc::None: break;
+            }
+            if (ru) out << *e.attacker << " атакует " << *e.target << " и наносит " << e.damage << " урона!\n";
+            else out << *e.attacker << " attacks " << *e.target << " for " << e.damage << " damage!\n";
+        }
+    }
+};
+
+// Буфер событий боя. Пачка передается потребителям при заполнении буфера
+// и по flush; без потребителей события просто отбрасываются.
+class CombatLog {
+private:
+    static constexpr size_t capacity = 4096;
+
+    std::vector<AttackEvent> events;
+    std::vector<std::unique_ptr<CombatEventSink>> sinks;
+
+public:
+    CombatLog() { events.reserve(capacity); }
+    ~CombatLog() { flush(); }
+
+    CombatLog(const CombatLog&) = delete;
+    CombatLog& operator=(const CombatLog&) = delete;
+
+    void addSink(std::unique_ptr<CombatEventSink> sink) { sinks.push_back(std::move(sink)); }
+
+    void record(const AttackEvent& e) {
+        events.push_back(e);
+        if (events.size() == capacity) flush();
+    }
+
+    void flush() {
+        if (events.empty()) return;
+        for (auto& sink : sinks) sink->consume(events);
+        events.clear();
+    }
+};
+
+class Entity {
+protected:
+    std::string name;
+    int health;
+    int attackPower;
+    int defense;
+
+public:
+    Entity(const std::string& n, int h, int a, int d)
+        : name(n), health(h), attackPower(a), defense(d) {
+    }
+
+    std::string getName() const {
+        return name;
+    }
+
+    int getHealth() const { return health; }
+    int getAttack() const { return attackPower; }
+    int getDefense() const { return defense; } 
+    void reduceHealth(int amount) { health -= amount; }
+
+protected:
+    // Урон удара по target через computeDamage с бонусом procRule().
+    // Бросок делается только при положительном уроне и ненулевом шансе
+    // бонуса; proc - сработал ли бонус
+    int strike(const Entity& target, Xoshiro256& rng, bool& proc) const {
+        ProcRule rule = procRule();
+        int roll = rule.chance > 0 && attackPower > target.getDefense() ? rng.roll(100) : 100;
+        proc = roll < rule.chance;
+        return computeDamage(attackPower, target.getDefense(), rule, roll);
+    }
+
+    // Нанести урон target и записать событие удара
+    void hit(Entity& target, int damage, AttackProc proc, CombatLanguage language, CombatLog& log) const {
+        target.reduceHealth(damage);
+        log.record({ &name, &target.name, damage, damage > 0 ? proc : AttackProc::None, language });
+    }
+
+public:
+
+    // Атака с генератором текущего потока
+    void attack(Entity& target, CombatLog& log) { attack(target, threadRng(), log); }
+
+    // Виртуальный метод для атаки; rng - источник бросков бонусов,
+    // удар записывается событием в log
+    virtual void attack(Entity& target, Xoshiro256& rng, CombatLog& log) {
+        bool proc = false;
+        int damage = strike(target, rng, proc);
+        hit(target, damage, AttackProc::None, CombatLanguage::English, log);
+    }
+
+    // Бонус атаки: его применяют attack() и пакетный расчет урона
+    virtual ProcRule procRule() const { return noProc; }
+
+    // Виртуальный метод для вывода информации
+    virtual void displayInfo() const {
+        std::cout << "Name: " << name << ", HP: " << health
+            << ", Attack: " << attackPower << ", Defense: " << defense << std::endl;
+    }
+
+    virtual void heal(int amount) {
+        if (amount > 0) {
+            health += amount;
+            std::cout << name << " восстанавливает " << amount << " HP!\n";
+        }
+    }
+
+    // Виртуальный деструктор
+    virtual ~Entity() {}
+};
+
+class Character : public Entity {
+public:
+    Character(const std::string& n, int h, int a, int d)
+        : Entity(n, h, a, d) {
+    }
+
+    using Entity::attack;
+
+    // Переопределение метода attack
+    void attack(Entity& target, Xoshiro256& rng, CombatLog& log) override {
+        bool proc = false;
+        int damage = strike(target, rng, proc);
+        // Шанс на критический удар (critProc)
+        hit(target, damage, proc ? AttackProc::Critical : AttackProc::None, CombatLanguage::English, log);
+    }
+
+    ProcRule procRule() const override { return critProc; }
+
+    // Переопределение метода displayInfo
+    void displayInfo() const override {
+        std::cout << "Character: " << name << ", HP: " << health
+            << ", Attack: " << attackPower << ", Defense: " << defense << std::endl;
+    }
+    // Переопределение метода heal с ограничением максимального здоровья
+    void heal(int amount) override {
+        if (amount > 0) {
+            int oldHealth = health;
+            health += amount;
+            if (health > 100) { // Предположим, что максимум HP для персонажа = 100
+                health = 100;
+            }
+            std::cout << name << " восстанавливает " << (health - oldHealth) << " HP!\n";
+        }
+    }
+};
+
+class Monster : public Entity {
+public:
+    Monster(const std::string& n, int h, int a, int d)
+        : Entity(n, h, a, d) {
+    }
+
+    using Entity::attack;
+
+    // Переопределение метода attack
+    void attack(Entity& target, Xoshiro256& rng, CombatLog& log) override {
+        bool proc = false;
+        int damage = strike(target, rng, proc);
+        // Шанс на ядовитую атаку (poisonProc)
+        hit(target, damage, proc ? AttackProc::Poison : AttackProc::None, CombatLanguage::English, log);
+    }
+
+    ProcRule procRule() const override { return poisonProc; }
+
+    // Переопределение метода displayInfo
+    void displayInfo() const override {
+        std::cout << "Monster: " << name << ", HP: " << health
+            << ", Attack: " << attackPower << ", Defense: " << defense << std::endl;
+    }
+};
+
+class Boss : public Monster {
+public:
+    Boss(const std::string& n, int h, int a, int d)
+        : Monster(n, h, a, d) {
+    }
+    using Monster::attack;
+
+    void attack(Entity& target, Xoshiro256& rng, CombatLog& log) override {
+        bool proc = false;
+        int damage = strike(target, rng, proc);
+        // Шанс на огненный удар (fireProc)
+        hit(target, damage, proc ? AttackProc::Fire : AttackProc::None, CombatLanguage::Russian, log);
+    }
+    ProcRule procRule() const override { return fireProc; }
+
+    void displayInfo() const override {
+        std::cout << "Босс: " << name << ", HP: " << health
+            << ", Атака: " << attackPower << ", Защита: " << defense << std::endl;
+    }
+};
+
+// ===== Пакетный расчет урона =====
+// Правила те же, что в computeDamage, через который считают удар attack()
+// и simulateDuel; урон вычитается из здоровья цели (здоровье, как и в
+// reduceHealth, не ограничивается нулем). Бросок 0..99 передается явно,
+// чтобы пакетный и поштучный расчет можно было сравнить.
+// Пакет предназначен для массовых ударов по разным целям (например, урон
+// по области). Бой и simulateDuel считают удары поштучно: состояние
+// дуэли помещается в регистры, и расчет дуэлей волнами через пакет
+// оказался примерно вдвое медленнее.
+
+// Пакет ударов в виде структуры массивов: элементы с номером i во всех
+// массивах относятся к i-й паре атакующий/цель. Каждая пара хранит свою
+// копию здоровья цели, поэтому цели в одном пакете не должны повторяться.
+struct DamageBatch {
+    std::vector<int32_t> attack;     // атака атакующего
+    std::vector<int32_t> chance;     // шанс бонуса атакующего, %
+    std::vector<int32_t> multiplier; // множитель урона при срабатывании бонуса
+    std::vector<int32_t> bonus;      // добавка к урону при срабатывании бонуса
+    std::vector<int32_t> defense;    // защита цели
+    std::vector<int32_t> health;     // здоровье цели, уменьшается на урон
+    std::vector<int32_t> roll;       // бросок 0..99
+    std::vector<int32_t> damage;     // результат: нанесенный урон
+
+    size_t size() const { return attack.size(); }
+
+    void add(const Entity& attacker, const Entity& target, int rollValue) {
+        ProcRule rule = attacker.procRule();
+        attack.push_back(attacker.getAttack());
+        chance.push_back(rule.chance);
+        multiplier.push_back(rule.multiplier);
+        bonus.push_back(rule.bonus);
+        defense.push_back(target.getDefense());
+        health.push_back(target.getHealth());
+        roll.push_back(rollValue);
+        damage.push_back(0);
+    }
+};
+
+inline void resolveDamageScalar(DamageBatch& b, size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+        b.damage[i] = computeDamage(b.attack[i], b.defense[i], { b.chance[i], b.multiplier[i], b.bonus[i] }, b.roll[i]);
+        b.health[i] -= b.damage[i];
+    }
+}
+
+#ifdef DAMAGE_SIMD_X86
+// Младшие 32 бита произведений (в SSE2 нет _mm_mullo_epi32)
+inline __m128i mulLow32(__m128i a, __m128i b) {
+    __m128i even = _mm_mul_epu32(a, b);
+    __m128i odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+    return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)),
+        _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+}
+
+// По 4 пары за итерацию; возвращает номер первой необработанной пары
+inline size_t resolveDamageSse2(DamageBatch& b) {
+    size_t n = b.size() & ~size_t(3);
+    const __m128i zero = _mm_setzero_si128();
+    for (size_t i = 0; i < n; i += 4) {
+        __m128i raw = _mm_sub_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(&b.attack[i])),
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(&b.defense[i])));
+        __m128i positive = _mm_cmpgt_epi32(raw, zero);
+        __m128i proc = _mm_cmpgt_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(&b.chance[i])),
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(&b.roll[i])));
+        __m128i boosted = _mm_add_epi32(mulLow32(raw, _mm_loadu_si128(reinterpret_cast<const __m128i*>(&b.multiplier[i]))),
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(&b.bonus[i])));
+        __m128i damage = _mm_or_si128(_mm_and_si128(proc, boosted), _mm_andnot_si128(proc, raw));
+        damage = _mm_and_si128(positive, damage);
+        __m128i health = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&b.health[i]));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(&b.damage[i]), damage);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(&b.health[i]), _mm_sub_epi32(health, damage));
+    }
+    return n;
+}
+
+// По 8 пар за итерацию; вызывается только при поддержке AVX2 процессором
+AVX2_TARGET inline size_t resolveDamageAvx2(DamageBatch& b) {
+    size_t n = b.size() & ~size_t(7);
+    const __m256i zero = _mm256_setzero_si256();
+    for (size_t i = 0; i < n; i += 8) {
+        __m256i raw = _mm256_sub_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(&b.attack[i])),
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&b.defense[i])));
+        __m256i positive = _mm256_cmpgt_epi32(raw, zero);
+        __m256i proc = _mm256_cmpgt_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(&b.chance[i])),
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&b.roll[i])));
+        __m256i boosted = _mm256_add_epi32(_mm256_mullo_epi32(raw, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&b.multiplier[i]))),
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&b.bonus[i])));
+        __m256i damage = _mm256_and_si256(positive, _mm256_blendv_epi8(raw, boosted, proc));
+        __m256i health = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&b.health[i]));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(&b.damage[i]), damage);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(&b.health[i]), _mm256_sub_epi32(health, damage));
+    }
+    return n;
+}
+
+inline bool cpuHasAvx2() {
+#ifdef _MSC_VER
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) return false;
+    __cpuid(info, 1);
+    bool osxsave = (info[2] & (1 << 27)) != 0;
+    bool avx = (info[2] & (1 << 28)) != 0;
+    if (!osxsave || !avx || (_xgetbv(0) & 6) != 6) return false;
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+#endif
+
+// Способ расчета пакета
+enum class DamageKernel { Scalar, Sse2, Avx2, Best };
+
+// Расчет всего пакета; хвост, не кратный ширине регистра, считается поштучно
+inline void resolveDamage(DamageBatch& b, DamageKernel kernel = DamageKernel::Best) {
+    size_t done = 0;
+#ifdef DAMAGE_SIMD_X86
+    static const bool avx2 = cpuHasAvx2();
+    if (kernel == DamageKernel::Best) kernel = avx2 ? DamageKernel::Avx2 : DamageKernel::Sse2;
+    if (kernel == DamageKernel::Avx2 && !avx2)
+        throw std::runtime_error("AVX2 не поддерживается процессором");
+    if (kernel == DamageKernel::Avx2) done = resolveDamageAvx2(b);
+    else if (kernel == DamageKernel::Sse2) done = resolveDamageSse2(b);
+#else
+    if (kernel == DamageKernel::Sse2 || kernel == DamageKernel::Avx2)
+        throw std::runtime_error("SIMD недоступен на этой платформе");
+#endif
+    resolveDamageScalar(b, done, b.size());
+}
+
+// Замер пакетного расчета: поштучный цикл против SSE2 и AVX2 на одних
+// и тех же данных с проверкой совпадения результатов. Малый пакет
+// помещается в кэш, большой упирается в пропускную способность памяти.
+void benchmarkDamageKernel() {
+    const size_t sizes[] = { 1 << 12, 1 << 22 };
+    const size_t totalPairs = 1 << 26; // на каждый размер пакета
+    const ProcRule rules[] = { noProc, critProc, poisonProc, fireProc };
+    const std::pair<DamageKernel, const char*> kernels[] = {
+        { DamageKernel::Scalar, "Поштучно" }, { DamageKernel::Sse2, "SSE2" }, { DamageKernel::Avx2, "AVX2" } };
+
+    for (size_t pairs : sizes) {
+        std::mt19937 rng(42);
+        std::uniform_int_distribution<int> stat(0, 60), health(1, 300), roll(0, 99), kind(0, 3);
+        DamageBatch input;
+        for (size_t i = 0; i < pairs; ++i) {
+            const ProcRule& rule = rules[kind(rng)];
+            input.attack.push_back(stat(rng));
+            input.chance.push_back(rule.chance);
+            input.multiplier.push_back(rule.multiplier);
+            input.bonus.push_back(rule.bonus);
+            input.defense.push_back(stat(rng));
+            input.health.push_back(health(rng));
+            input.roll.push_back(roll(rng));
+            input.damage.push_back(0);
+        }
+
+        std::cout << "=== Пакетный расчет урона (" << pairs << " пар в пакете) ===\n";
+        DamageBatch reference;
+        double scalarNs = 0;
+        for (const auto& k : kernels) {
+            size_t rounds = totalPairs / pairs;
+            DamageBatch batch = input;
+            double ns = 0;
+            try {
+                for (size_t r = 0; r < rounds; ++r) {
+                    batch.health = input.health;
+                    auto start = std::chrono::steady_clock::now();
+                    resolveDamage(batch, k.first);
+                    ns += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+                }
+            }
+            catch (const std::exception& e) {
+                std::cout << k.second << ": " << e.what() << "\n";
+                continue;
+            }
+            ns /= static_cast<double>(rounds * pairs);
+            if (k.first == DamageKernel::Scalar) {
+                reference = batch;
+                scalarNs = ns;
+            }
+            bool same = batch.health == reference.health && batch.damage == reference.damage;
+            std::cout << k.second << ": " << ns << " нс на пару, ускорение " << scalarNs / ns << "x"
+                << (same ? "" : " (РЕЗУЛЬТАТЫ РАСХОДЯТСЯ)") << "\n";
+        }
+    }
+}
+
+// ===== Параллельная симуляция дуэлей =====
+
+// Итоги серии дуэлей
+struct DuelStats {
+    uint64_t firstWins = 0;
+    uint64_t secondWins = 0;
+    uint64_t draws = 0;
+    uint64_t rounds = 0;
+
+    bool operator==(const DuelStats& other) const {
+        return firstWins == other.firstWins && secondWins == other.secondWins
+            && draws == other.draws && rounds == other.rounds;
+    }
+};
+
+// Одна дуэль без вывода по правилам attack(): first бьет первым,
+// бросок делается только при положительном уроне, как в attack()
+inline void simulateDuel(const Entity& first, const Entity& second, Xoshiro256& rng, DuelStats& stats) {
+    const int maxRounds = 1000;
+    const ProcRule firstRule = first.procRule();
+    const ProcRule secondRule = second.procRule();
+    const int toSecond = first.getAttack() - second.getDefense();
+    const int toFirst = second.getAttack() - first.getDefense();
+    int firstHealth = first.getHealth();
+    int secondHealth = second.getHealth();
+    for (int round = 1; round <= maxRounds; ++round) {
+        if (toSecond > 0) secondHealth -= computeDamage(first.getAttack(), second.getDefense(), firstRule, rng.roll(100));
+        if (secondHealth <= 0) {
+            ++stats.firstWins;
+            stats.rounds += round;
+            return;
+        }
+        if (toFirst > 0) firstHealth -= computeDamage(second.getAttack(), first.getDefense(), secondRule, rng.roll(100));
+        if (firstHealth <= 0) {
+            ++stats.secondWins;
+            stats.rounds += round;
+            return;
+        }
+    }
+    ++stats.draws;
+    stats.rounds += maxRounds;
+}
+
+// duels дуэлей на threads потоках. Дуэль i использует поток генератора
+// (seed, i), поэтому итог не зависит от числа потоков и разбиения.
+DuelStats simulateDuels(const Entity& first, const Entity& second, uint64_t duels, uint64_t seed, unsigned threads) {
+    threads = std::max(1u, threads);
+    std::vector<DuelStats> partial(threads);
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t] {
+            uint64_t begin = duels * t / threads, end = duels * (t + 1) / threads;
+            DuelStats local;
+            for (uint64_t i = begin; i < end; ++i) {
+                Xoshiro256 rng(seed, i);
+                simulateDuel(first, second, rng, local);
+            }
+            partial[t] = local;
+        });
+    }
+    for (auto& worker : workers) worker.join();
+
+    DuelStats total;
+    for (const auto& p : partial) {
+        total.firstWins += p.firstWins;
+        total.secondWins += p.secondWins;
+        total.draws += p.draws;
+        total.rounds += p.rounds;
+    }
+    return total;
+}
+
+// Замер бросков в цикле атак: rand() против xoshiro256**,
+// и проверка независимости симуляции от числа потоков
+void benchmarkCombatRng() {
+    const int attacks = 50000000;
+    std::cout << "=== Генератор бросков в цикле атак (" << attacks << " атак) ===\n";
+
+    srand(42);
+    long long total = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < attacks; ++i) {
+        total += computeDamage(20, i & 15, critProc, rand() % 100);
+    }
+    double randNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / attacks;
+    std::cout << "rand(): " << randNs << " нс на атаку (урон " << total << ")\n";
+
+    Xoshiro256 rng(42);
+    total = 0;
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < attacks; ++i) {
+        total += computeDamage(20, i & 15, critProc, rng.roll(100));
+    }
+    double xoshiroNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / attacks;
+    std::cout << "xoshiro256**: " << xoshiroNs << " нс на атаку (урон " << total << "), ускорение "
+        << randNs / xoshiroNs << "x\n";
+
+    Character hero("Hero", 100, 35, 10);
+    Boss dragon("Дракон", 120, 22, 20);
+    const uint64_t duels = 2000000;
+    DuelStats reference;
+    for (unsigned threads = 1; threads <= 8; threads *= 2) {
+        start = std::chrono::steady_clock::now();
+        DuelStats stats = simulateDuels(hero, dragon, duels, 42, threads);
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        if (threads == 1) reference = stats;
+        std::cout << "Дуэлей: " << duels << ", потоков: " << threads << ", " << ms << " мс, побед героя: "
+            << stats.firstWins << ", дракона: " << stats.secondWins
+            << (stats == reference ? "" : " (РЕЗУЛЬТАТЫ РАСХОДЯТСЯ)") << "\n";
+    }
+}
+
+int main(int argc, char* argv[]) {
+    setlocale(LC_ALL, "ru");
+    // Запуск с ключом --bench выполняет только замеры
+    if (argc > 1 && std::string(argv[1]) == "--bench") {
+        benchmarkDamageKernel();
+        benchmarkCombatRng();
+        return 0;
+    }
+    // Зерно генератора: из аргумента --seed N для повторения боя или от времени.
+    // Любые другие аргументы - ошибка, чтобы опечатка не давала случайный бой
+    auto usage = [](const std::string& error) {
+        std::cerr << error << "\nИспользование: [--bench | --seed N] (N - целое число от 0 до "
+            << UINT64_MAX << ")" << std::endl;
+        return 1;
+    };
+    uint64_t seed = static_cast<uint64_t>(time(0));
+    if (argc > 1) {
+        if (std::string(argv[1]) != "--seed") return usage(std::string("Неизвестный аргумент: ") + argv[1]);
+        if (argc != 3) return usage(argc < 3 ? "Не указано зерно" : "Лишние аргументы после зерна");
+        std::string text = argv[2];
+        size_t parsed = 0;
+        try {
+            if (text.empty() || text[0] == '-') throw std::invalid_argument(text);
+            seed = std::stoull(text, &parsed);
+        }
+        catch (const std::exception&) {
+            parsed = 0;
+        }
+        if (parsed == 0 || parsed != text.size()) return usage("Неверное зерно: " + text);
+    }
+    seedThreadRng(seed);
+    std::cout << "Зерно генератора: " << seed << std::endl;
+
+    // Создание объектов
+    Character hero("Hero", 100, 20, 10);
+    Monster goblin("Goblin", 50, 15, 5);
+
+    Boss dragon("Дракон", 150, 25, 20);
+
+    // Массив указателей на базовый класс
+    Entity* entities[] = { &hero, &goblin, &dragon };
+
+    // Полиморфное поведение
+    for (auto* entity : entities) {
+        entity->displayInfo(); // Вывод информации о сущности
+    }
+
+    // Бой между персонажем и монстрами
+    // Удары записываются событиями; консоль выводит их по flush
+    CombatLog log;
+    log.addSink(std::make_unique<ConsoleCombatSink>());
+    hero.attack(goblin, log);
+    goblin.attack(hero, log);
+    dragon.attack(hero, log);
+    log.flush();
+
+    std::cout << "\nСостояние после атак:\n";
+    hero.displayInfo();
+    goblin.displayInfo();
+    dragon.displayInfo();
+
+    hero.heal(30);
+    std::cout << "Состояние после лечения:\n";
+    hero.displayInfo();
+
+    return 0;
 }
\ No newline at end of file
@@ -1,324 +1,4216 @@
-﻿#include <iostream>
-#include <vector>
-#include <memory>
-#include <algorithm>
-#include <fstream>
-#include <sstream>
-#include <stdexcept>
-
-// Базовый класс пользователя
-class User {
-protected:
-    std::string name;
-    int id;
-    int accessLevel;
-
-public:
-    User(const std::string& name, int id, int accessLevel)
-        : name(name), id(id), accessLevel(accessLevel)
-    {
-        if (name.empty()) throw std::invalid_argument("Имя не может быть пустым");
-        if (accessLevel < 0) throw std::invalid_argument("Недопустимый уровень доступа");
-    }
-
-    virtual ~User() = default;
-
-    // Геттеры
-    std::string getName() const { return name; }
-    int getId() const { return id; }
-    int getAccessLevel() const { return accessLevel; }
-
-    // Сеттеры с проверкой входных данных
-    void setName(const std::string& newName) {
-        if (newName.empty()) throw std::invalid_argument("Имя не может быть пустым");
-        name = newName;
-    }
-
-    void setAccessLevel(int newLevel) {
-        if (newLevel < 0) throw std::invalid_argument("Недопустимый уровень доступа");
-        accessLevel = newLevel;
-    }
-
-    // Виртуальный метод для отображения информации
-    virtual void displayInfo() const {
-        std::cout << "Имя: " << name << ", ID: " << id
-            << ", Уровень доступа: " << accessLevel;
-    }
-};
-
-// Класс студента
-class Student : public User {
-    std::string group;
-
-public:
-    Student(const std::string& name, int id, int accessLevel, const std::string& group)
-        : User(name, id, accessLevel), group(group) {
-    }
-
-    std::string getGroup() const { return group; }
-
-    void displayInfo() const override {
-        User::displayInfo();
-        std::cout << ", Группа: " << group << " (Студент)\n";
-    }
-};
-
-// Класс преподавателя
-class Teacher : public User {
-    std::string department;
-
-public:
-    Teacher(const std::string& name, int id, int accessLevel, const std::string& department)
-        : User(name, id, accessLevel), department(department) {
-    }
-
-    std::string getDepartment() const { return department; }
-
-    void displayInfo() const override {
-        User::displayInfo();
-        std::cout << ", Кафедра: " << department << " (Преподаватель)\n";
-    }
-};
-
-// Класс администратора
-class Administrator : public User {
-    std::string office;
-
-public:
-    Administrator(const std::string& name, int id, int accessLevel, const std::string& office)
-        : User(name, id, accessLevel), office(office) {
-    }
-
-    std::string getOffice() const { return office; }
-
-    void displayInfo() const override {
-        User::displayInfo();
-        std::cout << ", Офис: " << office << " (Администратор)\n";
-    }
-};
-
-// Класс ресурса
-class Resource {
-    std::string name;
-    int requiredAccess;
-
-public:
-    Resource(const std::string& name, int requiredAccess)
-        : name(name), requiredAccess(requiredAccess)
-    {
-        if (name.empty()) throw std::invalid_argument("Имя ресурса не может быть пустым");
-        if (requiredAccess < 0) throw std::invalid_argument("Недопустимый уровень доступа");
-    }
-
-    // Проверка доступа пользователя к ресурсу
-    bool checkAccess(const User& user) const {
-        return user.getAccessLevel() >= requiredAccess;
-    }
-
-    std::string getName() const { return name; }
-    int getRequiredAccess() const { return requiredAccess; }
-};
-
-// Шаблонный класс системы контроля доступа
-template<typename T = Resource>
-class AccessControlSystem {
-    std::vector<std::unique_ptr<User>> users;
-    std::vector<T> resources;
-
-public:
-    // Добавление пользователя
-    void addUser(std::unique_ptr<User> user) {
-        users.push_back(std::move(user));
-    }
-
-    // Добавление ресурса
-    void addResource(const T& resource) {
-        resources.push_back(resource);
-    }
-
-    // Проверка доступа пользователя к ресурсу
-    bool checkAccess(int userId, const std::string& resourceName) const {
-        // Поиск пользователя
-        auto userIt = std::find_if(users.begin(), users.end(),
-            [userId](const auto& u) { return u->getId() == userId; });
-        if (userIt == users.end())
-            throw std::runtime_error("Пользователь не найден");
-
-        // Поиск ресурса
-        auto resIt = std::find_if(resources.begin(), resources.end(),
-            [&resourceName](const auto& r) { return r.getName() == resourceName; });
-        if (resIt == resources.end())
-            throw std::runtime_error("Ресурс не найден");
-
-        return resIt->checkAccess(**userIt);
-    }
-
-    // Сохранение пользователей в файл
-    void saveUsersToFile(const std::string& filename) const {
-        std::ofstream file(filename);
-        if (!file.is_open())
-            throw std::runtime_error("Не удалось открыть файл");
-
-        for (const auto& user : users) {
-            // Запись типа пользователя и его данных
-            if (auto s = dynamic_cast<Student*>(user.get())) {
-                file << "Student " << s->getName() << " " << s->getId() << " "
-                    << s->getAccessLevel() << " " << s->getGroup() << "\n";
-            }
-            else if (auto t = dynamic_cast<Teacher*>(user.get())) {
-                file << "Teacher " << t->getName() << " " << t->getId() << " "
-                    << t->getAccessLevel() << " " << t->getDepartment() << "\n";
-            }
-            else if (auto a = dynamic_cast<Administrator*>(user.get())) {
-                file << "Administrator " << a->getName() << " " << a->getId() << " "
-                    << a->getAccessLevel() << " " << a->getOffice() << "\n";
-            }
-        }
-    }
-
-    // Загрузка пользователей из файла
-    void loadUsersFromFile(const std::string& filename) {
-        std::ifstream file(filename);
-        if (!file.is_open())
-            throw std::runtime_error("Не удалось открыть файл");
-
-        std::string line;
-        while (std::getline(file, line)) {
-            std::istringstream iss(line);
-            std::string type, name, data;
-            int id, accessLevel;
-
-            iss >> type >> name >> id >> accessLevel >> data;
-
-            if (type == "Student") {
-                addUser(std::make_unique<Student>(name, id, accessLevel, data));
-            }
-            else if (type == "Teacher") {
-                addUser(std::make_unique<Teacher>(name, id, accessLevel, data));
-            }
-            else if (type == "Administrator") {
-                addUser(std::make_unique<Administrator>(name, id, accessLevel, data));
-            }
-        }
-    }
-
-    // Сохранение ресурсов в файл
-    void saveResourcesToFile(const std::string& filename) const {
-        std::ofstream file(filename);
-        if (!file.is_open())
-            throw std::runtime_error("Не удалось открыть файл");
-
-        for (const auto& resource : resources) {
-            file << resource.getName() << " " << resource.getRequiredAccess() << "\n";
-        }
-    }
-
-    // Загрузка ресурсов из файла
-    void loadResourcesFromFile(const std::string& filename) {
-        std::ifstream file(filename);
-        if (!file.is_open())
-            throw std::runtime_error("Не удалось открыть файл");
-
-        std::string line;
-        while (std::getline(file, line)) {
-            std::istringstream iss(line);
-            std::string name;
-            int requiredAccess;
-
-            iss >> name >> requiredAccess;
-            addResource(T(name, requiredAccess));
-        }
-    }
-
-    // Поиск пользователей по имени (может быть несколько с одинаковым именем)
-    std::vector<User*> findUsersByName(const std::string& name) const {
-        std::vector<User*> result;
-        for (const auto& u : users) {
-            if (u->getName() == name)
-                result.push_back(u.get());
-        }
-        return result;
-    }
-
-    // Поиск пользователя по ID
-    User* findUserById(int id) const {
-        auto it = std::find_if(users.begin(), users.end(),
-            [id](const auto& u) { return u->getId() == id; });
-        return it != users.end() ? it->get() : nullptr;
-    }
-
-    // Сортировка пользователей по уровню доступа
-    void sortByAccessLevel() {
-        std::sort(users.begin(), users.end(),
-            [](const auto& a, const auto& b) {
-                return a->getAccessLevel() < b->getAccessLevel();
-            });
-    }
-
-    // Вывод информации о всех пользователях
-    void printAllUsers() const {
-        for (const auto& user : users) {
-            user->displayInfo();
-        }
-    }
-
-    // Вывод информации о всех ресурсах
-    void printAllResources() const {
-        for (const auto& resource : resources) {
-            std::cout << "Ресурс: " << resource.getName()
-                << ", Требуемый уровень доступа: "
-                << resource.getRequiredAccess() << "\n";
-        }
-    }
-};
-
-int main() {
-    setlocale(LC_ALL, "ru");
-    try {
-        AccessControlSystem<> system;
-
-        // Добавление пользователей
-        system.addUser(std::make_unique<Student>("Иван", 1, 1, "Группа101"));
-        system.addUser(std::make_unique<Teacher>("Мария", 2, 2, "Информатика"));
-        system.addUser(std::make_unique<Administrator>("Ольга", 3, 5, "Кабинет200"));
-        system.addUser(std::make_unique<Student>("Иван", 4, 1, "Группа102")); // Еще один Иван
-
-        // Добавление ресурсов
-        system.addResource(Resource("Лаборатория1", 2));
-        system.addResource(Resource("Архив", 4));
-        system.addResource(Resource("Библиотека", 1));
-
-        // Сохранение данных
-        system.saveUsersToFile("users.txt");
-        system.saveResourcesToFile("resources.txt");
-
-        // Загрузка данных (можно закомментировать для теста)
-         AccessControlSystem<> newSystem;
-         newSystem.loadUsersFromFile("users.txt");
-         newSystem.printAllUsers();
-         newSystem.loadResourcesFromFile("resources.txt");
-         newSystem.printAllResources();
-        // Поиск пользователей по имени
-        auto ivanUsers = system.findUsersByName("Иван");
-        std::cout << "Найдено пользователей с именем Иван: " << ivanUsers.size() << "\n";
-        for (auto user : ivanUsers) {
-            user->displayInfo();
-        }
-
-        // Проверка доступа
-        std::cout << "Доступ Ивана в Лаборатория1: "
-            << system.checkAccess(1, "Лаборатория1") << "\n";
-        std::cout << "Доступ Марии в Архив: "
-            << system.checkAccess(2, "Архив") << "\n";
-
-        // Вывод всех ресурсов
-        std::cout << "\nВсе ресурсы:\n";
-        system.printAllResources();
-
-    }
-    catch (const std::exception& e) {
-        std::cerr << "Ошибка: " << e.what() << "\n";
-    }
-
-    return 0;
+﻿#include <iostream>
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <chrono>
+#include <random>
+#include <string_view>
+#include <span>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <queue>
+#include <atomic>
+#include <exception>
+#include <optional>
+#include <map>
+#include <climits>
+#include <cstdint>
+#include <cstring>
+#include <charconv>
+#include <filesystem>
+#include <utility>
+#include <ctime>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#ifdef __linux__
+#include <cerrno>
+#include <csignal>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/epoll.h>
+#include <sys/signalfd.h>
+#include <sys/eventfd.h>
+#include <sys/wait.h>
+#endif
+
+// Тип пользователя
+enum class UserType : uint8_t {
+    Student,
+    Teacher,
+    Administrator
+};
+
+// Роли - набор битов. Биты 0-31 соответствуют уровням доступа: уровень L
+// дает роли всех уровней от 0 до L, а ресурс с требуемым уровнем R требует
+// роль уровня R. Биты 32-63 - именованные роли Role. Ресурс требует любую из
+// ролей своей маски, поэтому проверка - одно AND с заранее вычисленными масками.
+using RoleMask = uint64_t;
+
+enum class Role : uint8_t {
+    Librarian,
+    LabAssistant,
+    Auditor
+};
+
+constexpr int maxRoleLevel = 31;
+constexpr RoleMask levelRolesMask = 0xFFFFFFFFull;
+constexpr int noLevelAccess = INT_MAX; // ресурс доступен только по именованным ролям
+
+constexpr RoleMask roleBit(Role role) { return RoleMask(1) << (32 + static_cast<int>(role)); }
+
+// Роли, которые дает уровень доступа пользователя (уровни выше 31 дают все)
+constexpr RoleMask levelGrant(int level) {
+    return level >= maxRoleLevel ? levelRolesMask : (RoleMask(2) << level) - 1;
+}
+
+// Роль, которую требует уровень доступа ресурса. Уровням выше 31 роли
+// не соответствует, их проверяет сравнение уровней в Resource::checkAccess.
+constexpr RoleMask levelRequirement(int level) {
+    return level > maxRoleLevel ? 0 : RoleMask(1) << level;
+}
+
+inline void validateNamedRoles(RoleMask roles) {
+    if (roles & levelRolesMask)
+        throw std::invalid_argument("Роли уровней задаются уровнем доступа");
+}
+
+// Хеш строк с поддержкой поиска по std::string_view без создания std::string
+struct StringHash {
+    using is_transparent = void;
+    size_t operator()(std::string_view s) const { return std::hash<std::string_view>{}(s); }
+};
+
+// Пул интернированных строк: каждая различная строка хранится один раз
+// в арене и получает компактный номер. Память не освобождается, поэтому
+// номера и string_view на строки пула действительны до конца программы.
+// Добавление защищено мьютексом; чтение по номеру не блокируется, так как
+// таблица строк состоит из сегментов, которые никогда не перемещаются.
+class StringPool {
+    static constexpr size_t blockSize = 64 * 1024;
+    static constexpr size_t segmentBits = 16;
+    static constexpr size_t segmentSize = size_t(1) << segmentBits;
+    static constexpr size_t maxSegments = 4096;
+
+    std::mutex mutex;
+    std::vector<std::unique_ptr<char[]>> blocks;
+    char* current = nullptr;
+    size_t blockUsed = blockSize;
+    size_t arenaBytes = 0;
+    std::unique_ptr<std::string_view[]> segments[maxSegments];
+    uint32_t count = 0;
+    std::unordered_map<std::string_view, uint32_t, StringHash, std::equal_to<>> ids;
+
+    // Копия строки в арене; длинные строки получают отдельный блок
+    std::string_view store(std::string_view s) {
+        if (s.empty()) return std::string_view();
+        char* target;
+        if (s.size() > blockSize / 4) {
+            blocks.push_back(std::make_unique<char[]>(s.size()));
+            arenaBytes += s.size();
+            target = blocks.back().get();
+        }
+        else {
+            if (blockUsed + s.size() > blockSize) {
+                blocks.push_back(std::make_unique<char[]>(blockSize));
+                arenaBytes += blockSize;
+                current = blocks.back().get();
+                blockUsed = 0;
+            }
+            target = current + blockUsed;
+            blockUsed += s.size();
+        }
+        std::memcpy(target, s.data(), s.size());
+        return std::string_view(target, s.size());
+    }
+
+public:
+    StringPool() { intern(std::string_view()); } // номер 0 - пустая строка
+
+    StringPool(const StringPool&) = delete;
+    StringPool& operator=(const StringPool&) = delete;
+
+    // Номер строки; при первом появлении строка копируется в арену
+    uint32_t intern(std::string_view s) {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = ids.find(s);
+        if (it != ids.end()) return it->second;
+        if (count == segmentSize * maxSegments)
+            throw std::length_error("Пул строк переполнен");
+
+        std::string_view stored = store(s);
+        auto& segment = segments[count >> segmentBits];
+        if (!segment) segment = std::make_unique<std::string_view[]>(segmentSize);
+        segment[count & (segmentSize - 1)] = stored;
+        ids.emplace(stored, count);
+        return count++;
+    }
+
+    std::string_view view(uint32_t id) const {
+        return segments[id >> segmentBits][id & (segmentSize - 1)];
+    }
+
+    // Резерв места в хеш-таблице под extra новых строк
+    void reserve(size_t extra) {
+        std::lock_guard<std::mutex> lock(mutex);
+        ids.reserve(ids.size() + extra);
+    }
+
+    // Номер строки без добавления (если строки в пуле нет - nullopt)
+    std::optional<uint32_t> find(std::string_view s) {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = ids.find(s);
+        if (it == ids.end()) return std::nullopt;
+        return it->second;
+    }
+
+    // Число различных строк и приблизительный объем памяти пула
+    size_t size() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return count;
+    }
+
+    size_t bytes() {
+        std::lock_guard<std::mutex> lock(mutex);
+        size_t segmentCount = (size_t(count) + segmentSize - 1) / segmentSize;
+        return arenaBytes + segmentCount * segmentSize * sizeof(std::string_view)
+            + ids.bucket_count() * sizeof(void*)
+            + ids.size() * (sizeof(std::pair<std::string_view, uint32_t>) + 2 * sizeof(void*));
+    }
+
+    // Общий пул для имен и дополнительных данных пользователей
+    static StringPool& global() {
+        static StringPool pool;
+        return pool;
+    }
+};
+
+// Базовый класс пользователя. Строковые поля хранятся номерами в общем пуле строк.
+class User {
+protected:
+    uint32_t name;
+    int id;
+    int accessLevel;
+    RoleMask roles = 0; // именованные роли
+
+public:
+    User(const std::string& name, int id, int accessLevel)
+        : name(StringPool::global().intern(name)), id(id), accessLevel(accessLevel)
+    {
+        if (name.empty()) throw std::invalid_argument("Имя не может быть пустым");
+        if (accessLevel < 0) throw std::invalid_argument("Недопустимый уровень доступа");
+    }
+
+    virtual ~User() = default;
+
+    // Тип пользователя и его дополнительные данные (группа, кафедра или офис)
+    virtual UserType getType() const = 0;
+    virtual std::string_view getDetails() const = 0;
+
+    // Геттеры
+    std::string_view getName() const { return StringPool::global().view(name); }
+    int getId() const { return id; }
+    int getAccessLevel() const { return accessLevel; }
+    RoleMask getRoles() const { return roles; }
+    RoleMask getEffectiveRoles() const { return roles | levelGrant(accessLevel); }
+
+    // Сеттеры с проверкой входных данных
+    void setName(const std::string& newName) {
+        if (newName.empty()) throw std::invalid_argument("Имя не может быть пустым");
+        name = StringPool::global().intern(newName);
+    }
+
+    void setAccessLevel(int newLevel) {
+        if (newLevel < 0) throw std::invalid_argument("Недопустимый уровень доступа");
+        accessLevel = newLevel;
+    }
+
+    void setRoles(RoleMask newRoles) {
+        validateNamedRoles(newRoles);
+        roles = newRoles;
+    }
+
+    // Виртуальный метод для отображения информации
+    virtual void displayInfo() const {
+        std::cout << "Имя: " << getName() << ", ID: " << id
+            << ", Уровень доступа: " << accessLevel;
+    }
+};
+
+// Класс студента
+class Student : public User {
+    uint32_t group;
+
+public:
+    Student(const std::string& name, int id, int accessLevel, const std::string& group)
+        : User(name, id, accessLevel), group(StringPool::global().intern(group)) {
+    }
+
+    std::string_view getGroup() const { return StringPool::global().view(group); }
+
+    UserType getType() const override { return UserType::Student; }
+    std::string_view getDetails() const override { return getGroup(); }
+
+    void displayInfo() const override {
+        User::displayInfo();
+        std::cout << ", Группа: " << getGroup() << " (Студент)\n";
+    }
+};
+
+// Класс преподавателя
+class Teacher : public User {
+    uint32_t department;
+
+public:
+    Teacher(const std::string& name, int id, int accessLevel, const std::string& department)
+        : User(name, id, accessLevel), department(StringPool::global().intern(department)) {
+    }
+
+    std::string_view getDepartment() const { return StringPool::global().view(department); }
+
+    UserType getType() const override { return UserType::Teacher; }
+    std::string_view getDetails() const override { return getDepartment(); }
+
+    void displayInfo() const override {
+        User::displayInfo();
+        std::cout << ", Кафедра: " << getDepartment() << " (Преподаватель)\n";
+    }
+};
+
+// Класс администратора
+class Administrator : public User {
+    uint32_t office;
+
+public:
+    Administrator(const std::string& name, int id, int accessLevel, const std::string& office)
+        : User(name, id, accessLevel), office(StringPool::global().intern(office)) {
+    }
+
+    std::string_view getOffice() const { return StringPool::global().view(office); }
+
+    UserType getType() const override { return UserType::Administrator; }
+    std::string_view getDetails() const override { return getOffice(); }
+
+    void displayInfo() const override {
+        User::displayInfo();
+        std::cout << ", Офис: " << getOffice() << " (Администратор)\n";
+    }
+};
+
+// Данные одного пользователя для добавления в систему
+struct UserRecord {
+    UserType type;
+    std::string name;
+    int id;
+    int accessLevel;
+    std::string details; // группа, кафедра или офис
+    RoleMask roles = 0;  // именованные роли
+
+    // Те же проверки, что и в конструкторе User
+    void validate() const {
+        if (name.empty()) throw std::invalid_argument("Имя не может быть пустым");
+        if (accessLevel < 0) throw std::invalid_argument("Недопустимый уровень доступа");
+        validateNamedRoles(roles);
+    }
+
+    static UserRecord from(const User& user) {
+        return { user.getType(), std::string(user.getName()), user.getId(), user.getAccessLevel(),
+            std::string(user.getDetails()), user.getRoles() };
+    }
+
+    void displayInfo() const {
+        std::cout << "Имя: " << name << ", ID: " << id << ", Уровень доступа: " << accessLevel;
+        switch (type) {
+        case UserType::Student:
+            std::cout << ", Группа: " << details << " (Студент)\n";
+            break;
+        case UserType::Teacher:
+            std::cout << ", Кафедра: " << details << " (Преподаватель)\n";
+            break;
+        case UserType::Administrator:
+            std::cout << ", Офис: " << details << " (Администратор)\n";
+            break;
+        }
+    }
+};
+
+// Условие отбора пользователей для массовых изменений: тип и/или группа,
+// кафедра или офис. Пустое условие выбирает всех пользователей.
+struct UserFilter {
+    std::optional<UserType> type;
+    std::optional<std::string> details;
+
+    static UserFilter ofType(UserType type) { return { type, std::nullopt }; }
+    static UserFilter group(const std::string& group) { return { UserType::Student, group }; }
+    static UserFilter department(const std::string& department) { return { UserType::Teacher, department }; }
+    static UserFilter office(const std::string& office) { return { UserType::Administrator, office }; }
+};
+
+// Название типа в текстовом формате файлов
+inline const char* userTypeName(UserType type) {
+    switch (type) {
+    case UserType::Student: return "Student";
+    case UserType::Teacher: return "Teacher";
+    default: return "Administrator";
+    }
+}
+
+inline bool parseUserType(std::string_view name, UserType& type) {
+    if (name == "Student") type = UserType::Student;
+    else if (name == "Teacher") type = UserType::Teacher;
+    else if (name == "Administrator") type = UserType::Administrator;
+    else return false;
+    return true;
+}
+
+// Ошибка разбора строки текстового файла
+struct LoadError {
+    size_t line; // номер строки, начиная с 1
+    std::string message;
+};
+
+// Разбор фрагмента users.txt (целое число строк). Пользователи дописываются
+// в users, ошибки - в errors с номерами строк относительно начала фрагмента.
+// Возвращает число строк во фрагменте.
+inline size_t parseUsersText(std::string_view text, std::vector<UserRecord>& users, std::vector<LoadError>& errors) {
+    auto isSpace = [](char c) { return c == ' ' || c == '\t' || c == '\r'; };
+    size_t lineNumber = 0;
+    size_t pos = 0;
+    while (pos < text.size()) {
+        size_t end = text.find('\n', pos);
+        if (end == std::string_view::npos) end = text.size();
+        std::string_view line = text.substr(pos, end - pos);
+        pos = end + 1;
+        ++lineNumber;
+
+        // Деление строки на поля по пробелам
+        std::string_view fields[6];
+        size_t fieldCount = 0;
+        size_t i = 0;
+        while (fieldCount < 6) {
+            while (i < line.size() && isSpace(line[i])) ++i;
+            if (i == line.size()) break;
+            size_t start = i;
+            while (i < line.size() && !isSpace(line[i])) ++i;
+            fields[fieldCount++] = line.substr(start, i - start);
+        }
+        if (fieldCount == 0) continue; // пустая строка
+
+        UserType type;
+        if (!parseUserType(fields[0], type)) {
+            errors.push_back({ lineNumber, "Неизвестный тип пользователя: " + std::string(fields[0]) });
+            continue;
+        }
+        if (fieldCount < 4) {
+            errors.push_back({ lineNumber, "Недостаточно полей" });
+            continue;
+        }
+
+        auto parseInt = [](std::string_view field, int& value) {
+            auto [ptr, ec] = std::from_chars(field.data(), field.data() + field.size(), value);
+            return ec == std::errc() && ptr == field.data() + field.size();
+        };
+        int id, accessLevel;
+        if (!parseInt(fields[2], id)) {
+            errors.push_back({ lineNumber, "Некорректный ID: " + std::string(fields[2]) });
+            continue;
+        }
+        if (!parseInt(fields[3], accessLevel)) {
+            errors.push_back({ lineNumber, "Некорректный уровень доступа: " + std::string(fields[3]) });
+            continue;
+        }
+
+        // Необязательное шестое поле - именованные роли (биты 32-63 маски)
+        uint32_t namedRoles = 0;
+        if (fieldCount == 6) {
+            auto [ptr, ec] = std::from_chars(fields[5].data(), fields[5].data() + fields[5].size(), namedRoles);
+            if (ec != std::errc() || ptr != fields[5].data() + fields[5].size()) {
+                errors.push_back({ lineNumber, "Некорректные роли: " + std::string(fields[5]) });
+                continue;
+            }
+        }
+
+        UserRecord record{ type, std::string(fields[1]), id, accessLevel, std::string(fields[4]),
+            RoleMask(namedRoles) << 32 };
+        try {
+            record.validate();
+        }
+        catch (const std::invalid_argument& e) {
+            errors.push_back({ lineNumber, e.what() });
+            continue;
+        }
+        users.push_back(std::move(record));
+    }
+    return lineNumber;
+}
+
+// Столбцовое хранилище пользователей: по одному непрерывному массиву
+// на каждое поле. Номер строки (слот) не меняется после добавления.
+// Имена и дополнительные данные - номера строк в StringPool::global(),
+// поэтому одинаковые строки хранятся один раз и сравниваются как числа.
+struct UserColumns {
+    std::vector<int> ids;
+    std::vector<int> accessLevels;
+    std::vector<UserType> types;
+    std::vector<uint32_t> names;
+    std::vector<uint32_t> details;
+    std::vector<RoleMask> roles; // действующие роли: именованные и роли уровня
+
+    size_t size() const { return ids.size(); }
+
+    std::string_view name(size_t slot) const { return StringPool::global().view(names[slot]); }
+    std::string_view detail(size_t slot) const { return StringPool::global().view(details[slot]); }
+
+    // Память столбцов без учета общего пула строк
+    size_t memoryBytes() const {
+        return ids.capacity() * sizeof(int) + accessLevels.capacity() * sizeof(int)
+            + types.capacity() * sizeof(UserType) + names.capacity() * sizeof(uint32_t)
+            + details.capacity() * sizeof(uint32_t) + roles.capacity() * sizeof(RoleMask);
+    }
+
+    void reserve(size_t count) {
+        ids.reserve(count);
+        accessLevels.reserve(count);
+        types.reserve(count);
+        names.reserve(count);
+        details.reserve(count);
+        roles.reserve(count);
+    }
+
+    void push_back(const UserRecord& record) {
+        push_back(record, StringPool::global().intern(record.name), StringPool::global().intern(record.details));
+    }
+
+    // Добавление с уже интернированными строками
+    void push_back(const UserRecord& record, uint32_t nameId, uint32_t detailsId) {
+        ids.push_back(record.id);
+        accessLevels.push_back(record.accessLevel);
+        types.push_back(record.type);
+        names.push_back(nameId);
+        details.push_back(detailsId);
+        roles.push_back(record.roles | levelGrant(record.accessLevel));
+    }
+};
+
+// Пользователи для массового добавления: записи проверяются и строки
+// интернируются один раз при создании, а не для каждого экземпляра состояния
+struct UserBatch {
+    std::vector<UserRecord> records;
+    std::vector<uint32_t> names;
+    std::vector<uint32_t> details;
+
+    explicit UserBatch(std::vector<UserRecord> users) : records(std::move(users)) {
+        for (const auto& record : records) record.validate();
+        StringPool& pool = StringPool::global();
+        pool.reserve(records.size());
+        names.reserve(records.size());
+        details.reserve(records.size());
+        for (const auto& record : records) {
+            names.push_back(pool.intern(record.name));
+            details.push_back(pool.intern(record.details));
+        }
+    }
+
+    size_t size() const { return records.size(); }
+};
+
+// Легковесное представление пользователя в столбцовом хранилище
+// с прежним интерфейсом User. Действительно до следующего изменения системы.
+class UserView {
+    const UserColumns* columns;
+    size_t slot;
+
+public:
+    UserView(const UserColumns& columns, size_t slot) : columns(&columns), slot(slot) {}
+
+    std::string_view getName() const { return columns->name(slot); }
+    int getId() const { return columns->ids[slot]; }
+    int getAccessLevel() const { return columns->accessLevels[slot]; }
+    UserType getType() const { return columns->types[slot]; }
+    RoleMask getRoles() const { return columns->roles[slot] & ~levelRolesMask; }
+    RoleMask getEffectiveRoles() const { return columns->roles[slot]; }
+    std::string_view getDetails() const { return columns->detail(slot); }
+
+    // Группа, кафедра и офис (пустая строка для пользователя другого типа)
+    std::string_view getGroup() const { return getType() == UserType::Student ? getDetails() : std::string_view(); }
+    std::string_view getDepartment() const { return getType() == UserType::Teacher ? getDetails() : std::string_view(); }
+    std::string_view getOffice() const { return getType() == UserType::Administrator ? getDetails() : std::string_view(); }
+
+    // Копия пользователя, не зависящая от хранилища
+    UserRecord toRecord() const {
+        return { getType(), std::string(getName()), getId(), getAccessLevel(), std::string(getDetails()), getRoles() };
+    }
+
+    void displayInfo() const { toRecord().displayInfo(); }
+};
+
+// Набор пользователей, заданный слотами, без копирования данных
+class UserRange {
+    const UserColumns* columns = nullptr;
+    std::span<const uint32_t> slots;
+
+public:
+    class iterator {
+        const UserColumns* columns;
+        const uint32_t* slot;
+
+    public:
+        iterator(const UserColumns* columns, const uint32_t* slot) : columns(columns), slot(slot) {}
+        UserView operator*() const { return UserView(*columns, *slot); }
+        iterator& operator++() { ++slot; return *this; }
+        bool operator!=(const iterator& other) const { return slot != other.slot; }
+    };
+
+    UserRange() = default;
+    UserRange(const UserColumns& columns, std::span<const uint32_t> slots) : columns(&columns), slots(slots) {}
+
+    size_t size() const { return slots.size(); }
+    bool empty() const { return slots.empty(); }
+    UserView operator[](size_t i) const { return UserView(*columns, slots[i]); }
+    iterator begin() const { return iterator(columns, slots.data()); }
+    iterator end() const { return iterator(columns, slots.data() + slots.size()); }
+};
+
+// Класс ресурса
+class Resource {
+    std::string name;
+    int requiredAccess;
+    RoleMask requiredRoles; // доступ есть при любой из этих ролей
+    int levelThreshold;     // для требуемого уровня выше 31: доступ при уровне больше порога
+
+public:
+    // Доступ по уровню не ниже requiredAccess или по любой из именованных
+    // ролей anyOfRoles; noLevelAccess - только по ролям
+    Resource(const std::string& name, int requiredAccess, RoleMask anyOfRoles = 0)
+        : name(name), requiredAccess(requiredAccess)
+    {
+        if (name.empty()) throw std::invalid_argument("Имя ресурса не может быть пустым");
+        if (requiredAccess < 0) throw std::invalid_argument("Недопустимый уровень доступа");
+        validateNamedRoles(anyOfRoles);
+        requiredRoles = levelRequirement(requiredAccess) | anyOfRoles;
+        levelThreshold = requiredAccess > maxRoleLevel && requiredAccess != noLevelAccess
+            ? requiredAccess - 1 : INT_MAX;
+    }
+
+    // Проверка доступа пользователя к ресурсу (User или UserView).
+    // Сравнение уровней выполняется, только если не подошла ни одна роль.
+    template<typename U>
+    bool checkAccess(const U& user) const {
+        return (user.getEffectiveRoles() & requiredRoles) != 0 || user.getAccessLevel() > levelThreshold;
+    }
+
+    std::string getName() const { return name; }
+    int getRequiredAccess() const { return requiredAccess; }
+    RoleMask getRequiredRoles() const { return requiredRoles; }
+    RoleMask getNamedRoles() const { return requiredRoles & ~levelRolesMask; }
+};
+
+// Пул потоков фиксированного размера для пакетной обработки
+class ThreadPool {
+    std::vector<std::thread> workers;
+    std::queue<std::function<void()>> tasks;
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool stopping = false;
+
+public:
+    explicit ThreadPool(size_t threadCount) {
+        if (threadCount == 0) threadCount = 1;
+        for (size_t i = 0; i < threadCount; ++i) {
+            workers.emplace_back([this] {
+                while (true) {
+                    std::function<void()> task;
+                    {
+                        std::unique_lock<std::mutex> lock(mutex);
+                        cv.wait(lock, [this] { return stopping || !tasks.empty(); });
+                        if (stopping && tasks.empty()) return;
+                        task = std::move(tasks.front());
+                        tasks.pop();
+                    }
+                    task();
+                }
+            });
+        }
+    }
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        cv.notify_all();
+        for (auto& w : workers) w.join();
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    size_t size() const { return workers.size(); }
+
+    // Постановка задачи в очередь; future сообщает о ее завершении
+    std::future<void> submit(std::function<void()> job) {
+        auto task = std::make_shared<std::packaged_task<void()>>(std::move(job));
+        auto result = task->get_future();
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            tasks.emplace([task] { (*task)(); });
+        }
+        cv.notify_one();
+        return result;
+    }
+
+    // Общий пул по числу ядер
+    static ThreadPool& shared() {
+        static ThreadPool pool(std::thread::hardware_concurrency());
+        return pool;
+    }
+};
+
+// Запрос пакетной проверки доступа: пара (ID пользователя, имя ресурса)
+struct AccessQuery {
+    int userId;
+    std::string_view resourceName;
+};
+
+// Результат проверки одной пары без исключений
+enum class AccessResult : unsigned char {
+    Allowed,
+    Denied,
+    UnknownUser,
+    UnknownResource
+};
+
+// Предвычисленная матрица решений: бит (строка пользователя, столбец ресурса)
+// равен 1, если доступ разрешен. Матрица хранится по столбцам, поэтому новый
+// ресурс добавляет один столбец, а смена уровня пользователя меняет по одному
+// биту в каждом столбце - таблица никогда не перестраивается целиком.
+class AccessMatrix {
+    std::vector<std::vector<uint64_t>> columns;
+    size_t rowCount = 0;
+
+    static size_t wordsFor(size_t rows) { return (rows + 63) / 64; }
+
+    static void assign(std::vector<uint64_t>& column, size_t row, bool allowed) {
+        uint64_t mask = uint64_t(1) << (row & 63);
+        if (allowed) column[row >> 6] |= mask;
+        else column[row >> 6] &= ~mask;
+    }
+
+public:
+    size_t rows() const { return rowCount; }
+    size_t cols() const { return columns.size(); }
+
+    bool test(size_t row, size_t col) const {
+        return (columns[col][row >> 6] >> (row & 63)) & 1;
+    }
+
+    // Новая строка; allowed(col) вычисляет бит для каждого ресурса
+    template<typename F>
+    void appendRow(F allowed) {
+        size_t row = rowCount++;
+        for (size_t col = 0; col < columns.size(); ++col) {
+            if (columns[col].size() < wordsFor(rowCount)) columns[col].push_back(0);
+            assign(columns[col], row, allowed(col));
+        }
+    }
+
+    // Пересчет одной строки (после смены уровня доступа пользователя)
+    template<typename F>
+    void updateRow(size_t row, F allowed) {
+        for (size_t col = 0; col < columns.size(); ++col)
+            assign(columns[col], row, allowed(col));
+    }
+
+    // Новый столбец; allowed(row) вычисляет бит для каждого пользователя
+    template<typename F>
+    void appendColumn(F allowed) {
+        std::vector<uint64_t> column(wordsFor(rowCount), 0);
+        for (size_t row = 0; row < rowCount; ++row)
+            if (allowed(row)) column[row >> 6] |= uint64_t(1) << (row & 63);
+        columns.push_back(std::move(column));
+    }
+
+    void clear() {
+        columns.clear();
+        rowCount = 0;
+    }
+
+    // Занимаемая память в байтах
+    size_t memoryBytes() const {
+        size_t bytes = sizeof(*this) + columns.capacity() * sizeof(columns[0]);
+        for (const auto& column : columns) bytes += column.capacity() * sizeof(uint64_t);
+        return bytes;
+    }
+};
+
+// Файл, отображенный в память только для чтения
+class MappedFile {
+    const char* bytes = nullptr;
+    size_t length = 0;
+#ifdef _WIN32
+    HANDLE file = INVALID_HANDLE_VALUE;
+    HANDLE mapping = nullptr;
+#endif
+
+public:
+    explicit MappedFile(const std::string& filename) {
+#ifdef _WIN32
+        file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+            OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+            throw std::runtime_error("Не удалось открыть файл");
+        LARGE_INTEGER fileSize;
+        GetFileSizeEx(file, &fileSize);
+        length = static_cast<size_t>(fileSize.QuadPart);
+        if (length == 0) return;
+        mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!mapping) {
+            CloseHandle(file);
+            throw std::runtime_error("Не удалось отобразить файл в память");
+        }
+        bytes = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+        if (!bytes) {
+            CloseHandle(mapping);
+            CloseHandle(file);
+            throw std::runtime_error("Не удалось отобразить файл в память");
+        }
+#else
+        int fd = open(filename.c_str(), O_RDONLY);
+        if (fd < 0)
+            throw std::runtime_error("Не удалось открыть файл");
+        struct stat st;
+        if (fstat(fd, &st) != 0) {
+            close(fd);
+            throw std::runtime_error("Не удалось открыть файл");
+        }
+        length = static_cast<size_t>(st.st_size);
+        if (length > 0) {
+            void* mapped = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapped == MAP_FAILED) {
+                close(fd);
+                throw std::runtime_error("Не удалось отобразить файл в память");
+            }
+            bytes = static_cast<const char*>(mapped);
+        }
+        close(fd);
+#endif
+    }
+
+    ~MappedFile() {
+#ifdef _WIN32
+        if (bytes) UnmapViewOfFile(bytes);
+        if (mapping) CloseHandle(mapping);
+        if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+#else
+        if (bytes) munmap(const_cast<char*>(bytes), length);
+#endif
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const char* data() const { return bytes; }
+    size_t size() const { return length; }
+};
+
+// Бинарный снимок (порядок байтов платформы, little-endian на x86/x64):
+// заголовок, массив записей пользователей, массив записей ресурсов,
+// с версии 2 - именованные роли (uint32_t на пользователя, затем на ресурс),
+// таблица строк. Строки задаются смещением и длиной в таблице строк.
+constexpr char snapshotMagic[4] = { 'A', 'C', 'S', 'B' };
+constexpr uint32_t snapshotVersion = 2;
+
+struct SnapshotHeader {
+    char magic[4];
+    uint32_t version;
+    uint64_t userCount;
+    uint64_t resourceCount;
+    uint64_t stringTableSize;
+};
+
+struct SnapshotString {
+    uint32_t offset;
+    uint32_t length;
+};
+
+struct SnapshotUser {
+    int32_t id;
+    int32_t accessLevel;
+    uint32_t type;      // UserType
+    SnapshotString name;
+    SnapshotString data; // группа, кафедра или офис
+};
+
+struct SnapshotResource {
+    int32_t requiredAccess;
+    SnapshotString name;
+};
+
+static_assert(sizeof(SnapshotHeader) == 32, "Неожиданный размер заголовка снимка");
+static_assert(sizeof(SnapshotUser) == 28, "Неожиданный размер записи пользователя");
+static_assert(sizeof(SnapshotResource) == 12, "Неожиданный размер записи ресурса");
+
+// Запись журнала аудита проверки доступа
+struct AuditRecord {
+    int64_t timestamp;   // наносекунды от начала эпохи system_clock
+    int32_t userId;
+    uint32_t resourceId; // индекс ресурса или auditUnknownResource
+    uint8_t verdict;     // AccessResult
+    uint8_t reserved[7];
+};
+
+static_assert(sizeof(AuditRecord) == 24, "Неожиданный размер записи аудита");
+
+constexpr uint32_t auditUnknownResource = UINT32_MAX;
+
+// Файл аудита: заголовок и следом записи AuditRecord
+constexpr char auditMagic[4] = { 'A', 'C', 'S', 'A' };
+constexpr uint32_t auditVersion = 1;
+
+struct AuditFileHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t recordSize;
+    uint32_t reserved;
+};
+
+// Кольцевой буфер без блокировок: один производитель (поток проверок)
+// и один потребитель (фоновый поток записи). При переполнении новые
+// записи отбрасываются и учитываются в счетчике.
+class AuditRing {
+    std::vector<AuditRecord> slots;
+    size_t mask;
+    alignas(64) std::atomic<uint64_t> head{ 0 };
+    alignas(64) std::atomic<uint64_t> tail{ 0 };
+    alignas(64) std::atomic<uint64_t> dropped{ 0 };
+    std::atomic<bool> producerExited{ false };
+    std::atomic<bool> consumerClosed{ false };
+
+public:
+    explicit AuditRing(size_t capacity) {
+        size_t size = 1;
+        while (size < capacity) size <<= 1;
+        slots.resize(size);
+        mask = size - 1;
+    }
+
+    bool push(const AuditRecord& record) noexcept {
+        uint64_t h = head.load(std::memory_order_relaxed);
+        if (h - tail.load(std::memory_order_acquire) >= slots.size()) {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        slots[h & mask] = record;
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Перенос накопленных записей в out (вызывает только потребитель)
+    size_t drainTo(std::vector<AuditRecord>& out) {
+        uint64_t t = tail.load(std::memory_order_relaxed);
+        uint64_t h = head.load(std::memory_order_acquire);
+        for (uint64_t i = t; i < h; ++i) out.push_back(slots[i & mask]);
+        tail.store(h, std::memory_order_release);
+        return static_cast<size_t>(h - t);
+    }
+
+    uint64_t droppedCount() const { return dropped.load(std::memory_order_relaxed); }
+
+    // Производитель завершился: после переноса записей буфер можно удалить
+    void retire() noexcept { producerExited.store(true, std::memory_order_release); }
+    bool retired() const noexcept { return producerExited.load(std::memory_order_acquire); }
+
+    // Журнал закрыт: производителю буфер больше не нужен
+    void close() noexcept { consumerClosed.store(true, std::memory_order_release); }
+    bool closed() const noexcept { return consumerClosed.load(std::memory_order_acquire); }
+};
+
+// Журнал аудита: каждый поток пишет в свой кольцевой буфер, фоновый
+// поток периодически переносит буферы пакетами в двоичный файл
+class AuditLog {
+    static std::atomic<uint64_t>& nextInstanceId() {
+        static std::atomic<uint64_t> id{ 1 };
+        return id;
+    }
+
+    const uint64_t instanceId = nextInstanceId().fetch_add(1);
+    const size_t ringCapacity;
+    const std::chrono::milliseconds interval;
+    std::ofstream file;
+
+    std::mutex ringsMutex;
+    std::vector<std::shared_ptr<AuditRing>> rings;
+    uint64_t retiredDropped = 0; // потери удаленных буферов, под ringsMutex
+
+    std::mutex drainMutex;
+    std::vector<AuditRecord> drainBuffer;
+    std::atomic<uint64_t> written{ 0 };
+
+    std::mutex wakeMutex;
+    std::condition_variable wake;
+    bool stopping = false;
+    std::thread drainer;
+
+    // Буферы потока по экземплярам журнала (идентификатор экземпляра
+    // защищает от повторного использования адреса). При завершении потока
+    // буферы помечаются, и фоновый поток удаляет их после переноса записей;
+    // буферы закрытых журналов поток отпускает при следующей регистрации.
+    class ThreadRings {
+        struct Entry {
+            uint64_t owner;
+            std::shared_ptr<AuditRing> ring;
+        };
+        std::vector<Entry> entries;
+
+    public:
+        ~ThreadRings() {
+            for (auto& entry : entries) entry.ring->retire();
+        }
+
+        AuditRing* find(uint64_t owner) const noexcept {
+            for (const auto& entry : entries)
+                if (entry.owner == owner) return entry.ring.get();
+            return nullptr;
+        }
+
+        void add(uint64_t owner, std::shared_ptr<AuditRing> ring) {
+            std::erase_if(entries, [](const Entry& entry) { return entry.ring->closed(); });
+            entries.push_back({ owner, std::move(ring) });
+        }
+    };
+
+    static ThreadRings& threadRings() {
+        thread_local ThreadRings local;
+        return local;
+    }
+
+    // Буфер текущего потока; выделяется при регистрации потока
+    AuditRing& localRing() {
+        ThreadRings& local = threadRings();
+        if (AuditRing* ring = local.find(instanceId)) return *ring;
+        auto ring = std::make_shared<AuditRing>(ringCapacity);
+        {
+            std::lock_guard<std::mutex> lock(ringsMutex);
+            rings.push_back(ring);
+        }
+        try {
+            local.add(instanceId, ring);
+        }
+        catch (...) {
+            ring->retire();
+            throw;
+        }
+        return *ring;
+    }
+
+    void drainAll() {
+        std::lock_guard<std::mutex> lock(drainMutex);
+        drainBuffer.clear();
+        {
+            std::lock_guard<std::mutex> ringsLock(ringsMutex);
+            size_t kept = 0;
+            for (auto& ring : rings) {
+                // Признак проверяется до переноса: после него записей не будет
+                bool retired = ring->retired();
+                ring->drainTo(drainBuffer);
+                if (retired) retiredDropped += ring->droppedCount();
+                else rings[kept++] = std::move(ring);
+            }
+            rings.resize(kept);
+        }
+        if (drainBuffer.empty()) return;
+        file.write(reinterpret_cast<const char*>(drainBuffer.data()), drainBuffer.size() * sizeof(AuditRecord));
+        file.flush();
+        written.fetch_add(drainBuffer.size(), std::memory_order_relaxed);
+    }
+
+public:
+    explicit AuditLog(const std::string& filename, size_t ringCapacity = 65536,
+        std::chrono::milliseconds interval = std::chrono::milliseconds(10))
+        : ringCapacity(ringCapacity), interval(interval), file(filename, std::ios::binary) {
+        if (!file.is_open())
+            throw std::runtime_error("Не удалось открыть файл аудита");
+        AuditFileHeader header{};
+        std::memcpy(header.magic, auditMagic, sizeof(auditMagic));
+        header.version = auditVersion;
+        header.recordSize = sizeof(AuditRecord);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+        drainer = std::thread([this] {
+            std::unique_lock<std::mutex> lock(wakeMutex);
+            while (!stopping) {
+                wake.wait_for(lock, this->interval, [this] { return stopping; });
+                lock.unlock();
+                drainAll();
+                lock.lock();
+            }
+        });
+    }
+
+    ~AuditLog() {
+        {
+            std::lock_guard<std::mutex> lock(wakeMutex);
+            stopping = true;
+        }
+        wake.notify_one();
+        drainer.join();
+        drainAll();
+        for (auto& ring : rings) ring->close();
+    }
+
+    AuditLog(const AuditLog&) = delete;
+    AuditLog& operator=(const AuditLog&) = delete;
+
+    // Регистрация текущего потока: буфер выделяется заранее, а не при
+    // первой записи. Незарегистрированный поток регистрируется в record().
+    void attachThread() { localRing(); }
+
+    // Запись решения; не блокируется, при переполнении буфера запись теряется
+    void record(int userId, uint32_t resourceId, AccessResult verdict) noexcept {
+        AuditRecord entry{};
+        entry.timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+        entry.userId = userId;
+        entry.resourceId = resourceId;
+        entry.verdict = static_cast<uint8_t>(verdict);
+        try {
+            localRing().push(entry);
+        }
+        catch (...) {
+            // Не удалось выделить буфер потока - запись теряется
+        }
+    }
+
+    // Немедленный перенос всех буферов в файл
+    void flush() { drainAll(); }
+
+    uint64_t recordsWritten() const { return written.load(std::memory_order_relaxed); }
+
+    uint64_t recordsDropped() {
+        std::lock_guard<std::mutex> lock(ringsMutex);
+        uint64_t total = retiredDropped;
+        for (const auto& ring : rings) total += ring->droppedCount();
+        return total;
+    }
+
+    // Чтение файла аудита
+    static std::vector<AuditRecord> readFile(const std::string& filename) {
+        MappedFile mapped(filename);
+        AuditFileHeader header;
+        if (mapped.size() < sizeof(header))
+            throw std::runtime_error("Файл аудита поврежден");
+        std::memcpy(&header, mapped.data(), sizeof(header));
+        if (std::memcmp(header.magic, auditMagic, sizeof(auditMagic)) != 0
+            || header.version != auditVersion || header.recordSize != sizeof(AuditRecord))
+            throw std::runtime_error("Неподдерживаемый формат файла аудита");
+
+        size_t count = (mapped.size() - sizeof(header)) / sizeof(AuditRecord);
+        std::vector<AuditRecord> records(count);
+        if (count > 0)
+            std::memcpy(records.data(), mapped.data() + sizeof(header), count * sizeof(AuditRecord));
+        return records;
+    }
+};
+
+// Журнал изменений (порядок байтов платформы): заголовок 'ACSJ' и версия,
+// затем записи [размер данных uint32][контрольная сумма uint32][тип uint8][данные].
+// Недописанная или поврежденная запись в конце файла (сбой при записи)
+// при чтении отбрасывается вместе со всем, что идет после нее.
+constexpr char journalMagic[4] = { 'A', 'C', 'S', 'J' };
+constexpr uint32_t journalVersion = 1;
+constexpr size_t journalHeaderSize = 8;
+constexpr size_t journalRecordHeaderSize = 9;
+
+enum class JournalOp : uint8_t {
+    AddUser,
+    AddResource,
+    SetAccessLevel,
+    SetName,
+    SetRoles,
+    SortByAccessLevel,
+    SetAccessLevelWhere
+};
+
+// FNV-1a, достаточно для обнаружения оборванной записи
+inline uint32_t journalChecksum(const char* data, size_t size) {
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= static_cast<unsigned char>(data[i]);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+// Формирование одной записи журнала в конце буфера
+class JournalRecordWriter {
+    std::string& out;
+    size_t start;
+
+public:
+    JournalRecordWriter(std::string& out, JournalOp op) : out(out), start(out.size()) {
+        out.append(journalRecordHeaderSize - 1, '\0');
+        out.push_back(static_cast<char>(op));
+    }
+
+    template<typename V>
+    void put(V value) {
+        out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+
+    void putString(std::string_view value) {
+        put(static_cast<uint32_t>(value.size()));
+        out.append(value);
+    }
+
+    // Заполнение размера и контрольной суммы (по типу и данным)
+    void finish() {
+        uint32_t size = static_cast<uint32_t>(out.size() - start - journalRecordHeaderSize);
+        uint32_t checksum = journalChecksum(out.data() + start + 8, out.size() - start - 8);
+        std::memcpy(&out[start], &size, sizeof(size));
+        std::memcpy(&out[start + 4], &checksum, sizeof(checksum));
+    }
+};
+
+// Последовательное чтение данных одной записи журнала
+class JournalRecordReader {
+    std::string_view data;
+
+public:
+    explicit JournalRecordReader(std::string_view data) : data(data) {}
+
+    template<typename V>
+    V get() {
+        if (data.size() < sizeof(V))
+            throw std::runtime_error("Запись журнала повреждена");
+        V value;
+        std::memcpy(&value, data.data(), sizeof(value));
+        data.remove_prefix(sizeof(value));
+        return value;
+    }
+
+    std::string getString() {
+        uint32_t size = get<uint32_t>();
+        if (data.size() < size)
+            throw std::runtime_error("Запись журнала повреждена");
+        std::string value(data.substr(0, size));
+        data.remove_prefix(size);
+        return value;
+    }
+};
+
+template<typename T> class AccessControlSystem;
+
+// Счетчик активных читателей, разнесенный по нескольким кеш-линиям,
+// чтобы потоки-читатели не конкурировали за одну переменную
+class ReadIndicator {
+    static constexpr size_t slotCount = 64;
+
+    struct alignas(64) Slot {
+        std::atomic<long> readers{ 0 };
+    };
+    Slot slots[slotCount];
+
+    static size_t threadSlot() {
+        static std::atomic<size_t> nextSlot{ 0 };
+        thread_local size_t slot = nextSlot.fetch_add(1) % slotCount;
+        return slot;
+    }
+
+public:
+    void arrive() { slots[threadSlot()].readers.fetch_add(1); }
+    void depart() { slots[threadSlot()].readers.fetch_sub(1); }
+
+    bool isEmpty() const {
+        for (const auto& s : slots) {
+            if (s.readers.load() != 0) return false;
+        }
+        return true;
+    }
+};
+
+// Состояние системы контроля доступа: пользователи, ресурсы и индексы.
+// Снаружи доступно только для чтения; изменяет его AccessControlSystem,
+// пока это состояние не опубликовано для читателей.
+template<typename T = Resource>
+class AccessState {
+    friend class AccessControlSystem<T>;
+
+    // Пользователи хранятся по столбцам; слот - номер строки в столбцах
+    UserColumns users;
+    std::vector<T> resources;
+
+    // Порядок вывода и сохранения пользователей (перестановка слотов).
+    // sortByAccessLevel меняет только ее, поэтому слоты и построенные
+    // по ним индексы остаются валидными.
+    std::vector<uint32_t> order;
+
+    // Хеш-индексы: ID -> слот пользователя и имя -> позиция ресурса в векторе.
+    // При повторяющихся ключах, как и при линейном поиске, находится первый.
+    std::unordered_map<int, size_t> usersById;
+    std::unordered_map<std::string, size_t, StringHash, std::equal_to<>> resourcesByName;
+
+    // Индекс имен: имя -> слоты всех пользователей с этим именем, плюс
+    // упорядоченный список различных имен для поиска по префиксу.
+    // Ключи - строки общего пула, значения unordered_map не перемещаются
+    // при рехешировании, поэтому упорядоченный список ссылается на них напрямую.
+    std::unordered_map<std::string_view, std::vector<uint32_t>, StringHash, std::equal_to<>> usersByName;
+    std::map<std::string_view, const std::vector<uint32_t>*> sortedNames;
+
+    // Упорядоченный индекс уровней доступа: уровень -> слоты пользователей.
+    // levelPosition[slot] - позиция слота в его группе, что позволяет
+    // перенести пользователя в другую группу за O(log L) без сдвигов.
+    std::map<int, std::vector<uint32_t>> usersByLevel;
+    std::vector<uint32_t> levelPosition;
+
+    // Необязательная матрица решений (строка - слот пользователя, столбец - ресурс)
+    AccessMatrix decisionMatrix;
+    bool decisionMatrixEnabled = false;
+
+    // Пакеты меньше этого размера проверяются в вызывающем потоке
+    static constexpr size_t parallelBatchThreshold = 4096;
+
+    // Буфер журнала: если задан, каждое успешное изменение дописывает в него запись
+    std::string* journal = nullptr;
+
+    static constexpr size_t npos = static_cast<size_t>(-1);
+
+    size_t findUserSlot(int id) const {
+        auto it = usersById.find(id);
+        return it != usersById.end() ? it->second : npos;
+    }
+
+    size_t findResourceIndex(std::string_view resourceName) const {
+        auto it = resourcesByName.find(resourceName);
+        return it != resourcesByName.end() ? it->second : npos;
+    }
+
+    bool allowed(size_t slot, size_t resourceIndex) const {
+        return resources[resourceIndex].checkAccess(UserView(users, slot));
+    }
+
+    // Решение для найденной пары: из матрицы, если она включена
+    bool decide(size_t slot, size_t resourceIndex) const {
+        if (decisionMatrixEnabled) return decisionMatrix.test(slot, resourceIndex);
+        return allowed(slot, resourceIndex);
+    }
+
+    void reserveUsers(size_t extra) {
+        users.reserve(users.size() + extra);
+        levelPosition.reserve(levelPosition.size() + extra);
+        order.reserve(order.size() + extra);
+        usersById.reserve(usersById.size() + extra);
+    }
+
+    void addToLevelIndex(size_t slot, int level) {
+        auto& group = usersByLevel[level];
+        if (slot == levelPosition.size()) levelPosition.push_back(0);
+        levelPosition[slot] = static_cast<uint32_t>(group.size());
+        group.push_back(static_cast<uint32_t>(slot));
+    }
+
+    // Удаление из группы уровня: на место слота встает последний в группе
+    void removeFromLevelIndex(size_t slot, int level) {
+        auto it = usersByLevel.find(level);
+        auto& group = it->second;
+        uint32_t moved = group.back();
+        group[levelPosition[slot]] = moved;
+        levelPosition[moved] = levelPosition[slot];
+        group.pop_back();
+        if (group.empty()) usersByLevel.erase(it);
+    }
+
+    // Добавление пользователя
+    void addUser(const UserRecord& record) {
+        record.validate();
+        addUser(record, StringPool::global().intern(record.name), StringPool::global().intern(record.details));
+    }
+
+    void addUser(const UserRecord& record, uint32_t nameId, uint32_t detailsId) {
+        size_t slot = users.size();
+        usersById.emplace(record.id, slot);
+        users.push_back(record, nameId, detailsId);
+        order.push_back(static_cast<uint32_t>(slot));
+        auto [nameIt, inserted] = usersByName.try_emplace(users.name(slot));
+        if (inserted) sortedNames.emplace(nameIt->first, &nameIt->second);
+        nameIt->second.push_back(static_cast<uint32_t>(slot));
+        addToLevelIndex(slot, record.accessLevel);
+        if (decisionMatrixEnabled)
+            decisionMatrix.appendRow([&](size_t col) { return allowed(slot, col); });
+
+        if (journal) {
+            JournalRecordWriter w(*journal, JournalOp::AddUser);
+            w.put(static_cast<uint8_t>(record.type));
+            w.put(static_cast<int32_t>(record.id));
+            w.put(static_cast<int32_t>(record.accessLevel));
+            w.put(record.roles);
+            w.putString(record.name);
+            w.putString(record.details);
+            w.finish();
+        }
+    }
+
+    // Массовое добавление: записи уже проверены и строки интернированы,
+    // память под столбцы, индексы и группы уровней выделяется один раз на пакет
+    void addUsers(const UserBatch& batch) {
+        reserveUsers(batch.size());
+        usersByName.reserve(usersByName.size() + batch.size());
+        std::map<int, size_t> perLevel;
+        for (const auto& record : batch.records) ++perLevel[record.accessLevel];
+        for (const auto& [level, count] : perLevel) {
+            auto& group = usersByLevel[level];
+            group.reserve(group.size() + count);
+        }
+        for (size_t i = 0; i < batch.size(); ++i) addUser(batch.records[i], batch.names[i], batch.details[i]);
+    }
+
+    // Смена уровня доступа всем пользователям, подходящим под filter.
+    // Дополнительные данные сравниваются по номерам в пуле строк. Из группы
+    // индекса уровней, теряющей большую часть слотов, они удаляются одним
+    // проходом, из остальных - по одному обменом с последним.
+    size_t setAccessLevelWhere(const UserFilter& filter, int newLevel) {
+        if (newLevel < 0)
+            throw std::invalid_argument("Недопустимый уровень доступа");
+
+        std::vector<uint32_t> matched;
+        std::vector<int> oldLevels;
+        std::optional<uint32_t> detailsId;
+        if (filter.details) detailsId = StringPool::global().find(*filter.details);
+        if (!filter.details || detailsId) {
+            for (size_t slot = 0; slot < users.size(); ++slot) {
+                if (filter.type && users.types[slot] != *filter.type) continue;
+                if (detailsId && users.details[slot] != *detailsId) continue;
+                if (users.accessLevels[slot] == newLevel) continue;
+                matched.push_back(static_cast<uint32_t>(slot));
+                oldLevels.push_back(users.accessLevels[slot]);
+                users.accessLevels[slot] = newLevel;
+                users.roles[slot] = (users.roles[slot] & ~levelRolesMask) | levelGrant(newLevel);
+            }
+        }
+
+        // Способ удаления из каждой затронутой группы: true - одним проходом
+        std::map<int, size_t> removed;
+        for (int level : oldLevels) ++removed[level];
+        std::map<int, bool> rebuild;
+        for (const auto& [level, count] : removed) rebuild[level] = count * 2 >= usersByLevel[level].size();
+        for (size_t i = 0; i < matched.size(); ++i) {
+            if (!rebuild[oldLevels[i]]) removeFromLevelIndex(matched[i], oldLevels[i]);
+        }
+        for (const auto& [level, whole] : rebuild) {
+            if (!whole) continue;
+            auto it = usersByLevel.find(level);
+            auto& group = it->second;
+            std::erase_if(group, [&](uint32_t slot) { return users.accessLevels[slot] != level; });
+            if (group.empty()) {
+                usersByLevel.erase(it);
+                continue;
+            }
+            for (size_t i = 0; i < group.size(); ++i) levelPosition[group[i]] = static_cast<uint32_t>(i);
+        }
+        if (!matched.empty()) {
+            auto& group = usersByLevel[newLevel];
+            group.reserve(group.size() + matched.size());
+            for (uint32_t slot : matched) {
+                levelPosition[slot] = static_cast<uint32_t>(group.size());
+                group.push_back(slot);
+            }
+        }
+
+        if (decisionMatrixEnabled) {
+            for (uint32_t slot : matched)
+                decisionMatrix.updateRow(slot, [&](size_t col) { return allowed(slot, col); });
+        }
+
+        if (journal && !matched.empty()) {
+            JournalRecordWriter w(*journal, JournalOp::SetAccessLevelWhere);
+            w.put(static_cast<uint8_t>(filter.type.has_value()));
+            w.put(static_cast<uint8_t>(filter.type.value_or(UserType::Student)));
+            w.put(static_cast<uint8_t>(filter.details.has_value()));
+            w.putString(filter.details.value_or(std::string()));
+            w.put(static_cast<int32_t>(newLevel));
+            w.finish();
+        }
+        return matched.size();
+    }
+
+    // Добавление ресурса
+    void addResource(const T& resource) {
+        size_t col = resources.size();
+        resourcesByName.emplace(resource.getName(), col);
+        resources.push_back(resource);
+        if (decisionMatrixEnabled)
+            decisionMatrix.appendColumn([&](size_t row) { return allowed(row, col); });
+
+        if (journal) {
+            JournalRecordWriter w(*journal, JournalOp::AddResource);
+            w.put(static_cast<int32_t>(resource.getRequiredAccess()));
+            w.put(resource.getNamedRoles());
+            w.putString(resource.getName());
+            w.finish();
+        }
+    }
+
+    // Изменение уровня доступа пользователя; пересчитывает его строку матрицы
+    void setAccessLevel(int userId, int newLevel) {
+        size_t slot = findUserSlot(userId);
+        if (slot == npos)
+            throw std::runtime_error("Пользователь не найден");
+        if (newLevel < 0)
+            throw std::invalid_argument("Недопустимый уровень доступа");
+        if (users.accessLevels[slot] != newLevel) {
+            removeFromLevelIndex(slot, users.accessLevels[slot]);
+            addToLevelIndex(slot, newLevel);
+        }
+        users.accessLevels[slot] = newLevel;
+        users.roles[slot] = (users.roles[slot] & ~levelRolesMask) | levelGrant(newLevel);
+        if (decisionMatrixEnabled)
+            decisionMatrix.updateRow(slot, [&](size_t col) { return allowed(slot, col); });
+
+        if (journal) {
+            JournalRecordWriter w(*journal, JournalOp::SetAccessLevel);
+            w.put(static_cast<int32_t>(userId));
+            w.put(static_cast<int32_t>(newLevel));
+            w.finish();
+        }
+    }
+
+    // Переименование пользователя с переносом в индексе имен
+    void setName(int userId, const std::string& newName) {
+        size_t slot = findUserSlot(userId);
+        if (slot == npos)
+            throw std::runtime_error("Пользователь не найден");
+        if (newName.empty())
+            throw std::invalid_argument("Имя не может быть пустым");
+
+        auto oldIt = usersByName.find(users.name(slot));
+        auto& oldSlots = oldIt->second;
+        oldSlots.erase(std::find(oldSlots.begin(), oldSlots.end(), static_cast<uint32_t>(slot)));
+        if (oldSlots.empty()) {
+            sortedNames.erase(oldIt->first);
+            usersByName.erase(oldIt);
+        }
+
+        users.names[slot] = StringPool::global().intern(newName);
+        auto [nameIt, inserted] = usersByName.try_emplace(users.name(slot));
+        if (inserted) sortedNames.emplace(nameIt->first, &nameIt->second);
+        // Слоты в группе имени идут по возрастанию, как при добавлении
+        auto& newSlots = nameIt->second;
+        newSlots.insert(std::upper_bound(newSlots.begin(), newSlots.end(), static_cast<uint32_t>(slot)),
+            static_cast<uint32_t>(slot));
+
+        if (journal) {
+            JournalRecordWriter w(*journal, JournalOp::SetName);
+            w.put(static_cast<int32_t>(userId));
+            w.putString(newName);
+            w.finish();
+        }
+    }
+
+    // Замена именованных ролей пользователя; роли уровня сохраняются
+    void setRoles(int userId, RoleMask namedRoles) {
+        size_t slot = findUserSlot(userId);
+        if (slot == npos)
+            throw std::runtime_error("Пользователь не найден");
+        validateNamedRoles(namedRoles);
+        users.roles[slot] = namedRoles | levelGrant(users.accessLevels[slot]);
+        if (decisionMatrixEnabled)
+            decisionMatrix.updateRow(slot, [&](size_t col) { return allowed(slot, col); });
+
+        if (journal) {
+            JournalRecordWriter w(*journal, JournalOp::SetRoles);
+            w.put(static_cast<int32_t>(userId));
+            w.put(namedRoles);
+            w.finish();
+        }
+    }
+
+    // Включение матрицы решений: строится один раз, дальше обновляется инкрементально
+    void enableDecisionMatrix() {
+        if (decisionMatrixEnabled) return;
+        decisionMatrix.clear();
+        for (size_t col = 0; col < resources.size(); ++col)
+            decisionMatrix.appendColumn([](size_t) { return false; });
+        for (size_t slot = 0; slot < users.size(); ++slot)
+            decisionMatrix.appendRow([&](size_t col) { return allowed(slot, col); });
+        decisionMatrixEnabled = true;
+    }
+
+    void disableDecisionMatrix() {
+        decisionMatrix.clear();
+        decisionMatrixEnabled = false;
+    }
+
+    // Сортировка пользователей по уровню доступа: порядок собирается за O(n)
+    // из групп индекса уровней, столбцы с данными не переставляются
+    void sortByAccessLevel() {
+        size_t i = 0;
+        for (const auto& [level, group] : usersByLevel) {
+            std::copy(group.begin(), group.end(), order.begin() + i);
+            i += group.size();
+        }
+
+        if (journal) {
+            JournalRecordWriter w(*journal, JournalOp::SortByAccessLevel);
+            w.finish();
+        }
+    }
+
+public:
+    size_t userCount() const { return users.size(); }
+    size_t resourceCount() const { return resources.size(); }
+
+    // Объем памяти матрицы решений в байтах (0, если выключена)
+    size_t decisionMatrixBytes() const {
+        return decisionMatrixEnabled ? decisionMatrix.memoryBytes() : 0;
+    }
+
+    // Проверка доступа пользователя к ресурсу; решение записывается в audit
+    bool checkAccess(int userId, std::string_view resourceName, AuditLog* audit = nullptr) const {
+        AccessResult result = tryCheckAccess(userId, resourceName, audit);
+
+        // Поиск пользователя
+        if (result == AccessResult::UnknownUser)
+            throw std::runtime_error("Пользователь не найден");
+
+        // Поиск ресурса
+        if (result == AccessResult::UnknownResource)
+            throw std::runtime_error("Ресурс не найден");
+
+        return result == AccessResult::Allowed;
+    }
+
+    // Проверка одной пары без исключений (используется пакетным API)
+    AccessResult tryCheckAccess(int userId, std::string_view resourceName, AuditLog* audit = nullptr) const noexcept {
+        AccessResult result;
+        size_t resourceIndex = findResourceIndex(resourceName);
+        size_t slot = findUserSlot(userId);
+        if (slot == npos) result = AccessResult::UnknownUser;
+        else if (resourceIndex == npos) result = AccessResult::UnknownResource;
+        else result = decide(slot, resourceIndex) ? AccessResult::Allowed : AccessResult::Denied;
+
+        if (audit) {
+            uint32_t resourceId = resourceIndex == npos ? auditUnknownResource : static_cast<uint32_t>(resourceIndex);
+            audit->record(userId, resourceId, result);
+        }
+        return result;
+    }
+
+    // Пакетная проверка доступа: results[i] - ответ на queries[i].
+    // Большие пакеты делятся на части и обрабатываются пулом потоков.
+    void checkAccessBatch(std::span<const AccessQuery> queries, std::span<AccessResult> results,
+        ThreadPool& pool = ThreadPool::shared(), AuditLog* audit = nullptr) const {
+        if (queries.size() != results.size())
+            throw std::invalid_argument("Размеры запросов и результатов не совпадают");
+
+        auto processRange = [this, queries, results, audit](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i)
+                results[i] = tryCheckAccess(queries[i].userId, queries[i].resourceName, audit);
+        };
+
+        if (queries.size() < parallelBatchThreshold || pool.size() < 2) {
+            processRange(0, queries.size());
+            return;
+        }
+
+        size_t chunkCount = pool.size();
+        size_t chunkSize = (queries.size() + chunkCount - 1) / chunkCount;
+        std::vector<std::future<void>> pending;
+        pending.reserve(chunkCount);
+        for (size_t begin = 0; begin < queries.size(); begin += chunkSize) {
+            size_t end = std::min(begin + chunkSize, queries.size());
+            pending.push_back(pool.submit([processRange, begin, end] { processRange(begin, end); }));
+        }
+        for (auto& f : pending) f.get();
+    }
+
+    // Сохранение пользователей в файл
+    void saveUsersToFile(const std::string& filename) const {
+        std::ofstream file(filename);
+        if (!file.is_open())
+            throw std::runtime_error("Не удалось открыть файл");
+
+        // Запись типа пользователя и его данных
+        for (uint32_t slot : order) {
+            file << userTypeName(users.types[slot]) << " " << users.name(slot) << " " << users.ids[slot] << " "
+                << users.accessLevels[slot] << " " << users.detail(slot);
+            // Именованные роли - необязательное последнее поле
+            if (uint32_t namedRoles = static_cast<uint32_t>(users.roles[slot] >> 32)) file << " " << namedRoles;
+            file << "\n";
+        }
+    }
+
+    // Сохранение ресурсов в файл
+    void saveResourcesToFile(const std::string& filename) const {
+        std::ofstream file(filename);
+        if (!file.is_open())
+            throw std::runtime_error("Не удалось открыть файл");
+
+        for (const auto& resource : resources) {
+            file << resource.getName() << " " << resource.getRequiredAccess();
+            if (uint32_t namedRoles = static_cast<uint32_t>(resource.getNamedRoles() >> 32)) file << " " << namedRoles;
+            file << "\n";
+        }
+    }
+
+    // Сохранение пользователей и ресурсов в бинарный снимок
+    void saveSnapshot(const std::string& filename) const {
+        std::string strings;
+        auto addString = [&strings](std::string_view value) {
+            SnapshotString ref{ static_cast<uint32_t>(strings.size()), static_cast<uint32_t>(value.size()) };
+            strings += value;
+            return ref;
+        };
+
+        std::vector<SnapshotUser> userRecords;
+        userRecords.reserve(order.size());
+        for (uint32_t slot : order) {
+            userRecords.push_back({ users.ids[slot], users.accessLevels[slot],
+                static_cast<uint32_t>(users.types[slot]), addString(users.name(slot)), addString(users.detail(slot)) });
+        }
+
+        std::vector<SnapshotResource> resourceRecords;
+        resourceRecords.reserve(resources.size());
+        for (const auto& resource : resources) {
+            resourceRecords.push_back({ resource.getRequiredAccess(), addString(resource.getName()) });
+        }
+
+        std::vector<uint32_t> roleRecords;
+        roleRecords.reserve(order.size() + resources.size());
+        for (uint32_t slot : order) roleRecords.push_back(static_cast<uint32_t>(users.roles[slot] >> 32));
+        for (const auto& resource : resources) roleRecords.push_back(static_cast<uint32_t>(resource.getNamedRoles() >> 32));
+
+        if (strings.size() > UINT32_MAX)
+            throw std::runtime_error("Таблица строк снимка слишком велика");
+
+        SnapshotHeader header{};
+        std::memcpy(header.magic, snapshotMagic, sizeof(snapshotMagic));
+        header.version = snapshotVersion;
+        header.userCount = userRecords.size();
+        header.resourceCount = resourceRecords.size();
+        header.stringTableSize = strings.size();
+
+        std::ofstream file(filename, std::ios::binary);
+        if (!file.is_open())
+            throw std::runtime_error("Не удалось открыть файл");
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(userRecords.data()), userRecords.size() * sizeof(SnapshotUser));
+        file.write(reinterpret_cast<const char*>(resourceRecords.data()), resourceRecords.size() * sizeof(SnapshotResource));
+        file.write(reinterpret_cast<const char*>(roleRecords.data()), roleRecords.size() * sizeof(uint32_t));
+        file.write(strings.data(), strings.size());
+        if (!file)
+            throw std::runtime_error("Ошибка записи снимка");
+    }
+
+    // Поиск пользователей по имени (может быть несколько с одинаковым именем).
+    // Возвращает диапазон по индексу без выделения памяти, в порядке добавления.
+    UserRange findUsersByName(std::string_view name) const {
+        auto it = usersByName.find(name);
+        if (it == usersByName.end()) return UserRange();
+        return UserRange(users, it->second);
+    }
+
+    // Первые limit пользователей, чьи имена начинаются с prefix (по алфавиту имен)
+    std::vector<UserView> findUsersByPrefix(std::string_view prefix, size_t limit) const {
+        std::vector<UserView> result;
+        for (auto it = sortedNames.lower_bound(prefix);
+            it != sortedNames.end() && result.size() < limit && it->first.starts_with(prefix); ++it) {
+            for (uint32_t slot : *it->second) {
+                if (result.size() == limit) break;
+                result.emplace_back(users, slot);
+            }
+        }
+        return result;
+    }
+
+    // Обход пользователей с уровнем доступа в [minLevel, maxLevel]
+    // в порядке возрастания уровня: O(log L + k)
+    template<typename F>
+    void forEachUserWithAccessLevel(int minLevel, int maxLevel, F f) const {
+        for (auto it = usersByLevel.lower_bound(minLevel); it != usersByLevel.end() && it->first <= maxLevel; ++it) {
+            for (uint32_t slot : it->second) f(UserView(users, slot));
+        }
+    }
+
+    // Пользователи одного уровня доступа (диапазон без копирования)
+    UserRange findUsersByAccessLevel(int level) const {
+        auto it = usersByLevel.find(level);
+        if (it == usersByLevel.end()) return UserRange();
+        return UserRange(users, it->second);
+    }
+
+    // Число пользователей с данным уровнем доступа
+    size_t countUsersWithAccessLevel(int level) const {
+        auto it = usersByLevel.find(level);
+        return it != usersByLevel.end() ? it->second.size() : 0;
+    }
+
+    // Число пользователей с уровнем не ниже minLevel
+    size_t countUsersWithAccessLevelAtLeast(int minLevel) const {
+        size_t count = 0;
+        for (auto it = usersByLevel.lower_bound(minLevel); it != usersByLevel.end(); ++it)
+            count += it->second.size();
+        return count;
+    }
+
+    // Пары (уровень, число пользователей) по возрастанию уровня
+    std::vector<std::pair<int, size_t>> accessLevelCounts() const {
+        std::vector<std::pair<int, size_t>> result;
+        result.reserve(usersByLevel.size());
+        for (const auto& [level, group] : usersByLevel) result.push_back({ level, group.size() });
+        return result;
+    }
+
+    // Автодополнение: первые limit различных имен, начинающихся с prefix
+    std::vector<std::string> completeName(std::string_view prefix, size_t limit) const {
+        std::vector<std::string> result;
+        for (auto it = sortedNames.lower_bound(prefix);
+            it != sortedNames.end() && result.size() < limit && it->first.starts_with(prefix); ++it) {
+            result.emplace_back(it->first);
+        }
+        return result;
+    }
+
+    // Поиск пользователя по ID
+    std::optional<UserView> findUserById(int id) const {
+        size_t slot = findUserSlot(id);
+        if (slot == npos) return std::nullopt;
+        return UserView(users, slot);
+    }
+
+    // Вывод информации о всех пользователях
+    void printAllUsers() const {
+        for (uint32_t slot : order) {
+            UserView(users, slot).displayInfo();
+        }
+    }
+
+    // Вывод информации о всех ресурсах
+    void printAllResources() const {
+        for (const auto& resource : resources) {
+            std::cout << "Ресурс: " << resource.getName() << ", Требуемый уровень доступа: ";
+            if (resource.getRequiredAccess() == noLevelAccess) std::cout << "нет";
+            else std::cout << resource.getRequiredAccess();
+            if (resource.getNamedRoles())
+                std::cout << ", Роли: 0x" << std::hex << (resource.getNamedRoles() >> 32) << std::dec;
+            std::cout << "\n";
+        }
+    }
+};
+
+// Шаблонный класс системы контроля доступа.
+// Данные хранятся в двух экземплярах AccessState (схема left-right):
+// читатели работают с опубликованным экземпляром и никогда не блокируются,
+// а писатель применяет пакет изменений ко второму экземпляру, публикует его
+// атомарной заменой указателя, дожидается ухода читателей со старого
+// экземпляра и повторяет на нем тот же пакет. Пока экземпляр опубликован,
+// он не меняется, то есть читатель всегда видит согласованный снимок.
+// Цена - двойной объем памяти под данные и двойное применение изменений.
+template<typename T = Resource>
+class AccessControlSystem {
+public:
+    // Пакет изменений, публикуемых одним новым снимком
+    class WriteBatch {
+        friend class AccessControlSystem;
+        std::vector<std::function<void(AccessState<T>&)>> ops;
+
+    public:
+        void addUser(UserRecord record) {
+            record.validate();
+            ops.push_back([record = std::move(record)](AccessState<T>& s) { s.addUser(record); });
+        }
+
+        void addUser(std::unique_ptr<User> user) {
+            if (!user) throw std::invalid_argument("Пустой пользователь");
+            addUser(UserRecord::from(*user));
+        }
+
+        // Массовое добавление пользователей одной операцией
+        void addUsers(std::vector<UserRecord> records) {
+            auto shared = std::make_shared<const UserBatch>(std::move(records));
+            ops.push_back([shared](AccessState<T>& s) { s.addUsers(*shared); });
+        }
+
+        void addResource(const T& resource) {
+            ops.push_back([resource](AccessState<T>& s) { s.addResource(resource); });
+        }
+
+        // Число измененных пользователей записывается в *changed (если задан)
+        void setAccessLevelWhere(UserFilter filter, int newLevel, std::shared_ptr<size_t> changed = nullptr) {
+            if (newLevel < 0) throw std::invalid_argument("Недопустимый уровень доступа");
+            ops.push_back([filter = std::move(filter), newLevel, changed](AccessState<T>& s) {
+                size_t count = s.setAccessLevelWhere(filter, newLevel);
+                if (changed) *changed = count;
+            });
+        }
+
+        void setAccessLevel(int userId, int newLevel) {
+            ops.push_back([userId, newLevel](AccessState<T>& s) { s.setAccessLevel(userId, newLevel); });
+        }
+
+        void setName(int userId, const std::string& newName) {
+            if (newName.empty()) throw std::invalid_argument("Имя не может быть пустым");
+            ops.push_back([userId, newName](AccessState<T>& s) { s.setName(userId, newName); });
+        }
+
+        void setRoles(int userId, RoleMask namedRoles) {
+            validateNamedRoles(namedRoles);
+            ops.push_back([userId, namedRoles](AccessState<T>& s) { s.setRoles(userId, namedRoles); });
+        }
+
+        void sortByAccessLevel() {
+            ops.push_back([](AccessState<T>& s) { s.sortByAccessLevel(); });
+        }
+
+        void enableDecisionMatrix() {
+            ops.push_back([](AccessState<T>& s) { s.enableDecisionMatrix(); });
+        }
+
+        void disableDecisionMatrix() {
+            ops.push_back([](AccessState<T>& s) { s.disableDecisionMatrix(); });
+        }
+
+        bool empty() const { return ops.empty(); }
+        size_t size() const { return ops.size(); }
+    };
+
+private:
+    AccessState<T> states[2];
+    std::atomic<AccessState<T>*> published{ &states[0] };
+    mutable ReadIndicator readIndicators[2];
+    std::atomic<int> versionIndex{ 0 };
+    std::mutex writerMutex;
+    // Глубина вложенных read() в текущем потоке: писатель ждет ухода всех
+    // читателей, поэтому запись изнутри обратного вызова чтения зависла бы
+    static inline thread_local int readDepth = 0;
+
+    void checkNotReading() const {
+        if (readDepth > 0)
+            throw std::logic_error("Изменение системы внутри read() или обхода пользователей");
+    }
+
+    // Журнал аудита проверок. Отключенные журналы хранятся до разрушения
+    // системы, так как проверки в других потоках могут еще писать в них.
+    std::atomic<AuditLog*> auditLog{ nullptr };
+    std::vector<std::unique_ptr<AuditLog>> auditLogs;
+    std::mutex auditMutex;
+
+    // Журнал изменений в каталоге journalDirectory: файлы journal.<N>.log
+    // и снимки snapshot.<N>.bin, где снимок N включает все журналы до N.
+    // Поля журнала меняются под writerMutex.
+    std::filesystem::path journalDirectory;
+    std::ofstream journalFile;
+    uint64_t journalGeneration = 0;
+    std::string journalBuffer;
+    std::thread compactor;
+    std::exception_ptr compactionError;
+
+    static std::filesystem::path journalPath(const std::filesystem::path& directory, uint64_t generation) {
+        return directory / ("journal." + std::to_string(generation) + ".log");
+    }
+
+    static std::filesystem::path snapshotPath(const std::filesystem::path& directory, uint64_t generation) {
+        return directory / ("snapshot." + std::to_string(generation) + ".bin");
+    }
+
+    // Номера файлов вида <prefix><N><extension> в каталоге, по возрастанию
+    static std::vector<uint64_t> generations(const std::filesystem::path& directory,
+        const std::string& prefix, const std::string& extension) {
+        std::vector<uint64_t> result;
+        for (const auto& entry : std::filesystem::directory_iterator(directory)) {
+            std::string name = entry.path().filename().string();
+            if (name.size() <= prefix.size() + extension.size() || !name.starts_with(prefix) || !name.ends_with(extension))
+                continue;
+            std::string_view number(name.data() + prefix.size(), name.size() - prefix.size() - extension.size());
+            uint64_t generation;
+            auto [ptr, ec] = std::from_chars(number.data(), number.data() + number.size(), generation);
+            if (ec == std::errc() && ptr == number.data() + number.size()) result.push_back(generation);
+        }
+        std::sort(result.begin(), result.end());
+        return result;
+    }
+
+    // Повтор записей журнала: sink - AccessState<T> или WriteBatch
+    template<typename Sink>
+    static void replayJournal(const std::filesystem::path& path, Sink& sink) {
+        MappedFile mapped(path.string());
+        const char* base = mapped.data();
+        uint32_t version;
+        if (mapped.size() < journalHeaderSize || std::memcmp(base, journalMagic, sizeof(journalMagic)) != 0)
+            throw std::runtime_error("Файл не является журналом");
+        std::memcpy(&version, base + 4, sizeof(version));
+        if (version != journalVersion)
+            throw std::runtime_error("Неподдерживаемая версия журнала");
+
+        size_t pos = journalHeaderSize;
+        while (pos + journalRecordHeaderSize <= mapped.size()) {
+            uint32_t size, checksum;
+            std::memcpy(&size, base + pos, sizeof(size));
+            std::memcpy(&checksum, base + pos + 4, sizeof(checksum));
+            // Оборванная запись в конце файла
+            if (size > mapped.size() - pos - journalRecordHeaderSize
+                || checksum != journalChecksum(base + pos + 8, size + 1))
+                break;
+
+            auto op = static_cast<JournalOp>(base[pos + 8]);
+            JournalRecordReader r(std::string_view(base + pos + journalRecordHeaderSize, size));
+            switch (op) {
+            case JournalOp::AddUser: {
+                UserRecord record;
+                uint8_t type = r.get<uint8_t>();
+                if (type > static_cast<uint8_t>(UserType::Administrator))
+                    throw std::runtime_error("Запись журнала повреждена");
+                record.type = static_cast<UserType>(type);
+                record.id = r.get<int32_t>();
+                record.accessLevel = r.get<int32_t>();
+                record.roles = r.get<RoleMask>();
+                record.name = r.getString();
+                record.details = r.getString();
+                sink.addUser(record);
+                break;
+            }
+            case JournalOp::AddResource: {
+                int requiredAccess = r.get<int32_t>();
+                RoleMask roles = r.get<RoleMask>();
+                sink.addResource(T(r.getString(), requiredAccess, roles));
+                break;
+            }
+            case JournalOp::SetAccessLevel: {
+                int userId = r.get<int32_t>();
+                sink.setAccessLevel(userId, r.get<int32_t>());
+                break;
+            }
+            case JournalOp::SetName: {
+                int userId = r.get<int32_t>();
+                sink.setName(userId, r.getString());
+                break;
+            }
+            case JournalOp::SetRoles: {
+                int userId = r.get<int32_t>();
+                sink.setRoles(userId, r.get<RoleMask>());
+                break;
+            }
+            case JournalOp::SortByAccessLevel:
+                sink.sortByAccessLevel();
+                break;
+            case JournalOp::SetAccessLevelWhere: {
+                UserFilter filter;
+                bool hasType = r.get<uint8_t>() != 0;
+                uint8_t type = r.get<uint8_t>();
+                bool hasDetails = r.get<uint8_t>() != 0;
+                std::string details = r.getString();
+                if (type > static_cast<uint8_t>(UserType::Administrator))
+                    throw std::runtime_error("Запись журнала повреждена");
+                if (hasType) filter.type = static_cast<UserType>(type);
+                if (hasDetails) filter.details = std::move(details);
+                sink.setAccessLevelWhere(filter, r.get<int32_t>());
+                break;
+            }
+            default:
+                throw std::runtime_error("Неизвестная запись журнала");
+            }
+            pos += journalRecordHeaderSize + size;
+        }
+    }
+
+    void openJournalFile() {
+        journalFile.open(journalPath(journalDirectory, journalGeneration), std::ios::binary | std::ios::trunc);
+        if (!journalFile.is_open())
+            throw std::runtime_error("Не удалось открыть файл журнала");
+        journalFile.write(journalMagic, sizeof(journalMagic));
+        journalFile.write(reinterpret_cast<const char*>(&journalVersion), sizeof(journalVersion));
+        journalFile.flush();
+    }
+
+    // Сворачивание: последний снимок плюс журналы до frozen включительно
+    // собираются в отдельном состоянии и сохраняются снимком frozen.
+    // Работает в фоне и не касается опубликованных состояний.
+    static void compactJournalFiles(const std::filesystem::path& directory, uint64_t frozen) {
+        auto snapshots = generations(directory, "snapshot.", ".bin");
+        uint64_t base = snapshots.empty() ? 0 : snapshots.back();
+
+        AccessState<T> state;
+        if (!snapshots.empty()) {
+            std::vector<UserRecord> loadedUsers;
+            std::vector<T> loadedResources;
+            readSnapshotFile(snapshotPath(directory, base).string(), loadedUsers, loadedResources);
+            state.addUsers(UserBatch(std::move(loadedUsers)));
+            for (const auto& resource : loadedResources) state.addResource(resource);
+        }
+        auto journals = generations(directory, "journal.", ".log");
+        for (uint64_t generation : journals) {
+            if (generation > base && generation <= frozen) replayJournal(journalPath(directory, generation), state);
+        }
+
+        // Новый снимок появляется под своим именем атомарно
+        auto temporary = directory / "snapshot.tmp";
+        state.saveSnapshot(temporary.string());
+        std::filesystem::rename(temporary, snapshotPath(directory, frozen));
+
+        for (uint64_t generation : snapshots) {
+            if (generation < frozen) std::filesystem::remove(snapshotPath(directory, generation));
+        }
+        for (uint64_t generation : journals) {
+            if (generation <= frozen) std::filesystem::remove(journalPath(directory, generation));
+        }
+    }
+
+    // Применение пакета под writerMutex. Если журнал открыт, записи об
+    // изменениях дописываются в него до публикации нового состояния.
+    void applyLocked(WriteBatch& batch) {
+        AccessState<T>* front = published.load();
+        AccessState<T>* back = front == &states[0] ? &states[1] : &states[0];
+
+        size_t applied = 0;
+        std::exception_ptr failure;
+        back->journal = journalFile.is_open() ? &journalBuffer : nullptr;
+        for (; applied < batch.ops.size(); ++applied) {
+            try {
+                batch.ops[applied](*back);
+            }
+            catch (...) {
+                failure = std::current_exception();
+                break;
+            }
+        }
+        back->journal = nullptr;
+
+        bool journalFailed = false;
+        if (!journalBuffer.empty()) {
+            journalFile.write(journalBuffer.data(), journalBuffer.size());
+            journalFile.flush();
+            journalFailed = !journalFile;
+            journalBuffer.clear();
+        }
+
+        if (applied > 0) {
+            published.store(back);
+            waitForReaders();
+            for (size_t i = 0; i < applied; ++i) batch.ops[i](*front);
+        }
+        if (failure) std::rethrow_exception(failure);
+        if (journalFailed)
+            throw std::runtime_error("Ошибка записи журнала");
+    }
+
+    // Ожидание, пока все читатели покинут ранее опубликованный экземпляр
+    void waitForReaders() {
+        int previous = versionIndex.load();
+        int next = 1 - previous;
+        while (!readIndicators[next].isEmpty()) std::this_thread::yield();
+        versionIndex.store(next);
+        while (!readIndicators[previous].isEmpty()) std::this_thread::yield();
+    }
+
+    // Ресурсы из текстового файла
+    static std::vector<T> readResourcesFile(const std::string& filename) {
+        std::ifstream file(filename);
+        if (!file.is_open())
+            throw std::runtime_error("Не удалось открыть файл");
+
+        std::vector<T> loaded;
+        std::string line;
+        while (std::getline(file, line)) {
+            std::istringstream iss(line);
+            std::string name;
+            int requiredAccess;
+            uint32_t namedRoles = 0;
+
+            iss >> name >> requiredAccess >> namedRoles;
+            loaded.push_back(T(name, requiredAccess, RoleMask(namedRoles) << 32));
+        }
+        return loaded;
+    }
+
+    // Пользователи и ресурсы из бинарного снимка, отображенного в память
+    static void readSnapshotFile(const std::string& filename,
+        std::vector<UserRecord>& loadedUsers, std::vector<T>& loadedResources) {
+        MappedFile mapped(filename);
+        const char* base = mapped.data();
+
+        SnapshotHeader header;
+        if (mapped.size() < sizeof(header))
+            throw std::runtime_error("Снимок поврежден");
+        std::memcpy(&header, base, sizeof(header));
+        if (std::memcmp(header.magic, snapshotMagic, sizeof(snapshotMagic)) != 0)
+            throw std::runtime_error("Файл не является снимком");
+        if (header.version != 1 && header.version != snapshotVersion)
+            throw std::runtime_error("Неподдерживаемая версия снимка");
+
+        // В снимках версии 1 ролей нет
+        uint64_t usersOffset = sizeof(header);
+        uint64_t resourcesOffset = usersOffset + header.userCount * sizeof(SnapshotUser);
+        uint64_t rolesOffset = resourcesOffset + header.resourceCount * sizeof(SnapshotResource);
+        uint64_t rolesSize = header.version >= 2 ? (header.userCount + header.resourceCount) * sizeof(uint32_t) : 0;
+        uint64_t stringsOffset = rolesOffset + rolesSize;
+        auto readRoles = [&](uint64_t index) {
+            if (!rolesSize) return RoleMask(0);
+            uint32_t namedRoles;
+            std::memcpy(&namedRoles, base + rolesOffset + index * sizeof(uint32_t), sizeof(namedRoles));
+            return RoleMask(namedRoles) << 32;
+        };
+        if (header.userCount > mapped.size() || header.resourceCount > mapped.size()
+            || stringsOffset + header.stringTableSize != mapped.size())
+            throw std::runtime_error("Снимок поврежден");
+
+        const char* strings = base + stringsOffset;
+        auto readString = [&](const SnapshotString& ref) {
+            if (uint64_t(ref.offset) + ref.length > header.stringTableSize)
+                throw std::runtime_error("Снимок поврежден");
+            return std::string(strings + ref.offset, ref.length);
+        };
+
+        loadedUsers.reserve(loadedUsers.size() + header.userCount);
+        for (uint64_t i = 0; i < header.userCount; ++i) {
+            SnapshotUser record;
+            std::memcpy(&record, base + usersOffset + i * sizeof(SnapshotUser), sizeof(record));
+            if (record.type > static_cast<uint32_t>(UserType::Administrator))
+                throw std::runtime_error("Неизвестный тип пользователя в снимке");
+            UserRecord user{ static_cast<UserType>(record.type), readString(record.name),
+                record.id, record.accessLevel, readString(record.data), readRoles(i) };
+            user.validate();
+            loadedUsers.push_back(std::move(user));
+        }
+
+        loadedResources.reserve(loadedResources.size() + header.resourceCount);
+        for (uint64_t i = 0; i < header.resourceCount; ++i) {
+            SnapshotResource record;
+            std::memcpy(&record, base + resourcesOffset + i * sizeof(SnapshotResource), sizeof(record));
+            loadedResources.push_back(T(readString(record.name), record.requiredAccess, readRoles(header.userCount + i)));
+        }
+    }
+
+    // Добавление загруженных данных одной операцией пакета
+    static void addLoaded(WriteBatch& batch, std::vector<UserRecord> loadedUsers,
+        std::vector<T> loadedResources) {
+        auto sharedUsers = std::make_shared<const UserBatch>(std::move(loadedUsers));
+        auto sharedResources = std::make_shared<const std::vector<T>>(std::move(loadedResources));
+        batch.ops.push_back([sharedUsers, sharedResources](AccessState<T>& s) {
+            s.addUsers(*sharedUsers);
+            for (const auto& resource : *sharedResources) s.addResource(resource);
+        });
+    }
+
+    // Копирование найденных пользователей внутри read()
+    template<typename Users>
+    static std::vector<UserRecord> toRecords(const Users& users) {
+        std::vector<UserRecord> records;
+        records.reserve(users.size());
+        for (const auto& user : users) records.push_back(user.toRecord());
+        return records;
+    }
+
+public:
+    AccessControlSystem() = default;
+
+    ~AccessControlSystem() {
+        if (compactor.joinable()) compactor.join();
+    }
+
+    AccessControlSystem(const AccessControlSystem&) = delete;
+    AccessControlSystem& operator=(const AccessControlSystem&) = delete;
+
+    // Разбор users.txt без загрузки в систему. Файл отображается в память
+    // и делится на фрагменты по границам строк; фрагменты разбираются
+    // пулом потоков в собственные буферы и объединяются по порядку.
+    // Ошибки не прерывают разбор и собираются в errors с номерами строк.
+    static std::vector<UserRecord> readUsersFile(const std::string& filename, std::vector<LoadError>& errors,
+        ThreadPool& pool = ThreadPool::shared()) {
+        const size_t minChunkSize = 1 << 20;
+
+        MappedFile mapped(filename);
+        std::string_view text(mapped.data(), mapped.size());
+
+        size_t chunkCount = std::min(pool.size() * 4, text.size() / minChunkSize);
+        if (chunkCount < 2) {
+            std::vector<UserRecord> loaded;
+            parseUsersText(text, loaded, errors);
+            return loaded;
+        }
+
+        // Границы фрагментов сдвигаются до начала следующей строки
+        std::vector<size_t> bounds{ 0 };
+        for (size_t i = 1; i < chunkCount; ++i) {
+            size_t target = std::max(bounds.back(), text.size() / chunkCount * i);
+            size_t newline = text.find('\n', target);
+            bounds.push_back(newline == std::string_view::npos ? text.size() : newline + 1);
+        }
+        bounds.push_back(text.size());
+
+        struct Chunk {
+            std::vector<UserRecord> users;
+            std::vector<LoadError> errors;
+            size_t lines = 0;
+        };
+        std::vector<Chunk> chunks(chunkCount);
+        std::vector<std::future<void>> pending;
+        for (size_t i = 0; i < chunkCount; ++i) {
+            pending.push_back(pool.submit([&, i] {
+                std::string_view part = text.substr(bounds[i], bounds[i + 1] - bounds[i]);
+                chunks[i].lines = parseUsersText(part, chunks[i].users, chunks[i].errors);
+            }));
+        }
+        for (auto& f : pending) f.get();
+
+        // Объединение буферов и пересчет номеров строк
+        size_t total = 0;
+        for (const auto& chunk : chunks) total += chunk.users.size();
+        std::vector<UserRecord> loaded;
+        loaded.reserve(total);
+        size_t firstLine = 0;
+        for (auto& chunk : chunks) {
+            std::move(chunk.users.begin(), chunk.users.end(), std::back_inserter(loaded));
+            for (auto& error : chunk.errors) {
+                error.line += firstLine;
+                errors.push_back(std::move(error));
+            }
+            firstLine += chunk.lines;
+        }
+        return loaded;
+    }
+
+    // Чтение согласованного снимка: f получает const AccessState<T>&.
+    // Не блокируется писателями; ссылки на данные снимка нельзя
+    // сохранять после возврата из f.
+    template<typename F>
+    decltype(auto) read(F&& f) const {
+        ReadIndicator& indicator = readIndicators[versionIndex.load()];
+        indicator.arrive();
+        ++readDepth;
+        struct Departure {
+            ReadIndicator& indicator;
+            ~Departure() { --readDepth; indicator.depart(); }
+        } departure{ indicator };
+        return f(static_cast<const AccessState<T>&>(*published.load()));
+    }
+
+    // Применение пакета изменений и публикация нового снимка.
+    // Если операция пакета отклонена исключением, публикуются
+    // предшествующие ей операции, а исключение передается вызывающему.
+    // Вызов изнутри read() в том же потоке - std::logic_error.
+    void apply(WriteBatch batch) {
+        checkNotReading();
+        if (batch.empty()) return;
+        std::lock_guard<std::mutex> lock(writerMutex);
+        applyLocked(batch);
+    }
+
+    // Добавление пользователя
+    void addUser(std::unique_ptr<User> user) {
+        WriteBatch batch;
+        batch.addUser(std::move(user));
+        apply(std::move(batch));
+    }
+
+    void addUser(UserRecord record) {
+        WriteBatch batch;
+        batch.addUser(std::move(record));
+        apply(std::move(batch));
+    }
+
+    // Массовое добавление пользователей: одна публикация на весь набор
+    void addUsers(std::vector<UserRecord> records) {
+        WriteBatch batch;
+        batch.addUsers(std::move(records));
+        apply(std::move(batch));
+    }
+
+    // Смена уровня доступа группе, кафедре, офису или типу пользователей.
+    // Возвращает число измененных пользователей.
+    size_t setAccessLevelWhere(const UserFilter& filter, int newLevel) {
+        auto changed = std::make_shared<size_t>(0);
+        WriteBatch batch;
+        batch.setAccessLevelWhere(filter, newLevel, changed);
+        apply(std::move(batch));
+        return *changed;
+    }
+
+    // Добавление ресурса
+    void addResource(const T& resource) {
+        WriteBatch batch;
+        batch.addResource(resource);
+        apply(std::move(batch));
+    }
+
+    // Изменение уровня доступа пользователя (с пересчетом строки матрицы решений)
+    void setAccessLevel(int userId, int newLevel) {
+        WriteBatch batch;
+        batch.setAccessLevel(userId, newLevel);
+        apply(std::move(batch));
+    }
+
+    // Переименование пользователя
+    void setName(int userId, const std::string& newName) {
+        WriteBatch batch;
+        batch.setName(userId, newName);
+        apply(std::move(batch));
+    }
+
+    // Открытие журнала изменений в каталоге (вызывается для пустой системы):
+    // загружается последний снимок и повторяется только хвост журнала после
+    // него. Дальше каждое изменение дописывает в журнал небольшую запись.
+    void openJournal(const std::string& directory) {
+        checkNotReading();
+        std::lock_guard<std::mutex> lock(writerMutex);
+        if (journalFile.is_open())
+            throw std::runtime_error("Журнал уже открыт");
+        if (published.load()->userCount() || published.load()->resourceCount())
+            throw std::runtime_error("Журнал открывается до добавления данных");
+
+        std::filesystem::create_directories(directory);
+        auto snapshots = generations(directory, "snapshot.", ".bin");
+        auto journals = generations(directory, "journal.", ".log");
+        uint64_t base = snapshots.empty() ? 0 : snapshots.back();
+
+        WriteBatch batch;
+        if (!snapshots.empty()) {
+            std::vector<UserRecord> loadedUsers;
+            std::vector<T> loadedResources;
+            readSnapshotFile(snapshotPath(directory, base).string(), loadedUsers, loadedResources);
+            addLoaded(batch, std::move(loadedUsers), std::move(loadedResources));
+        }
+        for (uint64_t generation : journals) {
+            if (generation > base) replayJournal(journalPath(directory, generation), batch);
+        }
+        if (!batch.empty()) applyLocked(batch);
+
+        // Запись всегда идет в новый файл, прежние сворачиваются при сжатии
+        journalDirectory = directory;
+        journalGeneration = std::max(base, journals.empty() ? 0 : journals.back()) + 1;
+        openJournalFile();
+    }
+
+    // Запуск фонового сворачивания журнала в снимок. Текущий файл журнала
+    // закрывается, новые изменения идут в следующий.
+    void compactJournal() {
+        std::lock_guard<std::mutex> lock(writerMutex);
+        if (!journalFile.is_open())
+            throw std::runtime_error("Журнал не открыт");
+        if (compactor.joinable()) compactor.join();
+
+        journalFile.close();
+        uint64_t frozen = journalGeneration++;
+        openJournalFile();
+        compactor = std::thread([this, directory = journalDirectory, frozen] {
+            try {
+                compactJournalFiles(directory, frozen);
+            }
+            catch (...) {
+                compactionError = std::current_exception();
+            }
+        });
+    }
+
+    // Ожидание завершения сворачивания; ошибка сворачивания пробрасывается
+    void waitForCompaction() {
+        std::thread running;
+        {
+            std::lock_guard<std::mutex> lock(writerMutex);
+            running = std::move(compactor);
+        }
+        if (running.joinable()) running.join();
+        if (compactionError) std::rethrow_exception(std::exchange(compactionError, nullptr));
+    }
+
+    void closeJournal() {
+        waitForCompaction();
+        std::lock_guard<std::mutex> lock(writerMutex);
+        journalFile.close();
+    }
+
+    // Именованные роли пользователя (биты Role)
+    void setRoles(int userId, RoleMask namedRoles) {
+        WriteBatch batch;
+        batch.setRoles(userId, namedRoles);
+        apply(std::move(batch));
+    }
+
+    // Включение матрицы решений: строится один раз, дальше обновляется инкрементально
+    void enableDecisionMatrix() {
+        WriteBatch batch;
+        batch.enableDecisionMatrix();
+        apply(std::move(batch));
+    }
+
+    void disableDecisionMatrix() {
+        WriteBatch batch;
+        batch.disableDecisionMatrix();
+        apply(std::move(batch));
+    }
+
+    // Сортировка пользователей по уровню доступа
+    void sortByAccessLevel() {
+        WriteBatch batch;
+        batch.sortByAccessLevel();
+        apply(std::move(batch));
+    }
+
+    // Загрузка пользователей из файла (разбор выполняется до публикации).
+    // Корректные строки загружаются, ошибочные возвращаются списком.
+    std::vector<LoadError> loadUsersFromFile(const std::string& filename, ThreadPool& pool = ThreadPool::shared()) {
+        std::vector<LoadError> errors;
+        WriteBatch batch;
+        addLoaded(batch, readUsersFile(filename, errors, pool), {});
+        apply(std::move(batch));
+        return errors;
+    }
+
+    // Загрузка ресурсов из файла
+    void loadResourcesFromFile(const std::string& filename) {
+        WriteBatch batch;
+        addLoaded(batch, {}, readResourcesFile(filename));
+        apply(std::move(batch));
+    }
+
+    // Загрузка бинарного снимка через отображение файла в память
+    void loadSnapshot(const std::string& filename) {
+        std::vector<UserRecord> loadedUsers;
+        std::vector<T> loadedResources;
+        readSnapshotFile(filename, loadedUsers, loadedResources);
+        WriteBatch batch;
+        addLoaded(batch, std::move(loadedUsers), std::move(loadedResources));
+        apply(std::move(batch));
+    }
+
+    size_t decisionMatrixBytes() const {
+        return read([](const auto& s) { return s.decisionMatrixBytes(); });
+    }
+
+    // Включение журнала аудита: каждое решение checkAccess, tryCheckAccess
+    // и checkAccessBatch записывается в двоичный файл
+    void enableAudit(const std::string& filename, size_t ringCapacity = 65536) {
+        auto log = std::make_unique<AuditLog>(filename, ringCapacity);
+        std::lock_guard<std::mutex> lock(auditMutex);
+        auditLog.store(log.get());
+        auditLogs.push_back(std::move(log));
+    }
+
+    void disableAudit() {
+        std::lock_guard<std::mutex> lock(auditMutex);
+        if (AuditLog* log = auditLog.exchange(nullptr)) log->flush();
+    }
+
+    // Текущий журнал аудита (nullptr, если выключен)
+    AuditLog* audit() const { return auditLog.load(); }
+
+    // Проверка доступа пользователя к ресурсу
+    bool checkAccess(int userId, const std::string& resourceName) const {
+        return read([&](const auto& s) { return s.checkAccess(userId, resourceName, auditLog.load()); });
+    }
+
+    // Проверка одной пары без исключений
+    AccessResult tryCheckAccess(int userId, std::string_view resourceName) const noexcept {
+        return read([&](const auto& s) { return s.tryCheckAccess(userId, resourceName, auditLog.load()); });
+    }
+
+    // Пакетная проверка доступа на одном снимке
+    void checkAccessBatch(std::span<const AccessQuery> queries, std::span<AccessResult> results,
+        ThreadPool& pool = ThreadPool::shared()) const {
+        read([&](const auto& s) { s.checkAccessBatch(queries, results, pool, auditLog.load()); });
+    }
+
+    void saveUsersToFile(const std::string& filename) const {
+        read([&](const auto& s) { s.saveUsersToFile(filename); });
+    }
+
+    void saveResourcesToFile(const std::string& filename) const {
+        read([&](const auto& s) { s.saveResourcesToFile(filename); });
+    }
+
+    void saveSnapshot(const std::string& filename) const {
+        read([&](const auto& s) { s.saveSnapshot(filename); });
+    }
+
+    // Поиск пользователей по имени и по ID. Возвращаются копии: следующее
+    // изменение переиспользует экземпляр состояния, поэтому представления
+    // UserView доступны только внутри read(), forEachUserWithName
+    // и forEachUserWithAccessLevel.
+    std::vector<UserRecord> findUsersByName(std::string_view name) const {
+        return read([&](const auto& s) { return toRecords(s.findUsersByName(name)); });
+    }
+
+    // Обход пользователей с точным именем внутри read(): без выделения памяти
+    template<typename F>
+    void forEachUserWithName(std::string_view name, F f) const {
+        read([&](const auto& s) { for (const UserView& user : s.findUsersByName(name)) f(user); });
+    }
+
+    std::vector<UserRecord> findUsersByPrefix(std::string_view prefix, size_t limit) const {
+        return read([&](const auto& s) { return toRecords(s.findUsersByPrefix(prefix, limit)); });
+    }
+
+    std::vector<std::string> completeName(std::string_view prefix, size_t limit) const {
+        return read([&](const auto& s) { return s.completeName(prefix, limit); });
+    }
+
+    // Запросы к индексу уровней доступа
+    template<typename F>
+    void forEachUserWithAccessLevel(int minLevel, int maxLevel, F f) const {
+        read([&](const auto& s) { s.forEachUserWithAccessLevel(minLevel, maxLevel, f); });
+    }
+
+    std::vector<UserRecord> findUsersByAccessLevel(int level) const {
+        return read([&](const auto& s) { return toRecords(s.findUsersByAccessLevel(level)); });
+    }
+
+    size_t countUsersWithAccessLevel(int level) const {
+        return read([&](const auto& s) { return s.countUsersWithAccessLevel(level); });
+    }
+
+    size_t countUsersWithAccessLevelAtLeast(int minLevel) const {
+        return read([&](const auto& s) { return s.countUsersWithAccessLevelAtLeast(minLevel); });
+    }
+
+    std::vector<std::pair<int, size_t>> accessLevelCounts() const {
+        return read([](const auto& s) { return s.accessLevelCounts(); });
+    }
+
+    std::optional<UserRecord> findUserById(int id) const {
+        return read([&](const auto& s) -> std::optional<UserRecord> {
+            auto user = s.findUserById(id);
+            if (!user) return std::nullopt;
+            return user->toRecord();
+        });
+    }
+
+    void printAllUsers() const {
+        read([](const auto& s) { s.printAllUsers(); });
+    }
+
+    void printAllResources() const {
+        read([](const auto& s) { s.printAllResources(); });
+    }
+};
+
+// Конвертация текстовых файлов в бинарный снимок и обратно
+void convertTextToSnapshot(const std::string& usersFile, const std::string& resourcesFile,
+    const std::string& snapshotFile) {
+    AccessControlSystem<> system;
+    for (const auto& error : system.loadUsersFromFile(usersFile))
+        std::cerr << usersFile << ":" << error.line << ": " << error.message << "\n";
+    system.loadResourcesFromFile(resourcesFile);
+    system.saveSnapshot(snapshotFile);
+}
+
+void convertSnapshotToText(const std::string& snapshotFile, const std::string& usersFile,
+    const std::string& resourcesFile) {
+    AccessControlSystem<> system;
+    system.loadSnapshot(snapshotFile);
+    system.saveUsersToFile(usersFile);
+    system.saveResourcesToFile(resourcesFile);
+}
+
+#ifdef __linux__
+// Локальная служба проверки доступа через Unix-сокет.
+// Протокол: кадры [DaemonFrameHeader][тело], ответы приходят в порядке запросов,
+// поэтому клиент может отправлять следующие кадры, не дожидаясь ответов.
+//   Check:  тело - записи { int32 userId; uint16 длина имени; имя ресурса },
+//           ответ - по одному байту AccessResult на запись
+//   Reload: пустое тело, ответ - 1 байт (1 - перезагрузка начата, 0 - уже идет)
+// Данные перезагружаются по Reload или SIGHUP без разрыва соединений.
+enum class DaemonMessage : uint32_t {
+    Check = 1,
+    Reload = 2
+};
+
+struct DaemonFrameHeader {
+    uint32_t size; // размер тела
+    uint32_t type; // DaemonMessage
+};
+
+constexpr size_t daemonMaxFrame = 16 * 1024 * 1024;
+// Пока неотправленных ответов больше порога, служба не читает запросы клиента
+constexpr size_t daemonOutHighWater = 4 * 1024 * 1024;
+
+// Блокирующие отправка и прием ровно size байт
+inline void sendAll(int fd, const char* data, size_t size) {
+    while (size > 0) {
+        ssize_t n = send(fd, data, size, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) throw std::runtime_error("Соединение разорвано");
+        data += n;
+        size -= static_cast<size_t>(n);
+    }
+}
+
+inline void receiveAll(int fd, char* data, size_t size) {
+    while (size > 0) {
+        ssize_t n = recv(fd, data, size, 0);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) throw std::runtime_error("Соединение разорвано");
+        data += n;
+        size -= static_cast<size_t>(n);
+    }
+}
+
+template<typename V>
+void appendBytes(std::vector<char>& out, const V& value) {
+    size_t at = out.size();
+    out.resize(at + sizeof(value));
+    std::memcpy(out.data() + at, &value, sizeof(value));
+}
+
+// Кадр Check с запросами batch в конце буфера frame
+inline void appendCheckFrame(std::vector<char>& frame, std::span<const AccessQuery> batch) {
+    for (const auto& q : batch) {
+        if (q.resourceName.size() > UINT16_MAX)
+            throw std::invalid_argument("Имя ресурса длиннее 65535 байт");
+    }
+    size_t start = frame.size();
+    appendBytes(frame, DaemonFrameHeader{ 0, static_cast<uint32_t>(DaemonMessage::Check) });
+    for (const auto& q : batch) {
+        appendBytes(frame, static_cast<int32_t>(q.userId));
+        appendBytes(frame, static_cast<uint16_t>(q.resourceName.size()));
+        frame.insert(frame.end(), q.resourceName.begin(), q.resourceName.end());
+    }
+    uint32_t size = static_cast<uint32_t>(frame.size() - start - sizeof(DaemonFrameHeader));
+    std::memcpy(frame.data() + start, &size, sizeof(size));
+}
+
+// Ответ на тело кадра Check в конце буфера out; false - тело повреждено.
+// queries и results - переиспользуемые буферы вызывающего.
+template<typename T>
+bool appendCheckReply(const AccessControlSystem<T>& system, const char* body, size_t size,
+    std::vector<AccessQuery>& queries, std::vector<AccessResult>& results, std::vector<char>& out) {
+    queries.clear();
+    size_t pos = 0;
+    while (pos < size) {
+        int32_t userId;
+        uint16_t length;
+        if (size - pos < sizeof(userId) + sizeof(length)) return false;
+        std::memcpy(&userId, body + pos, sizeof(userId));
+        std::memcpy(&length, body + pos + sizeof(userId), sizeof(length));
+        pos += sizeof(userId) + sizeof(length);
+        if (size - pos < length) return false;
+        queries.push_back({ userId, std::string_view(body + pos, length) });
+        pos += length;
+    }
+
+    results.resize(queries.size());
+    AuditLog* audit = system.audit();
+    system.read([&](const auto& s) {
+        for (size_t i = 0; i < queries.size(); ++i)
+            results[i] = s.tryCheckAccess(queries[i].userId, queries[i].resourceName, audit);
+    });
+
+    appendBytes(out, DaemonFrameHeader{ static_cast<uint32_t>(results.size()), static_cast<uint32_t>(DaemonMessage::Check) });
+    size_t at = out.size();
+    out.resize(at + results.size());
+    for (size_t i = 0; i < results.size(); ++i) out[at + i] = static_cast<char>(results[i]);
+    return true;
+}
+
+class AccessDaemon {
+    struct Connection {
+        explicit Connection(int fd) : fd(fd) {}
+
+        int fd;
+        std::vector<char> in;
+        size_t inUsed = 0;
+        std::vector<char> out;
+        size_t outSent = 0;
+        uint32_t events = EPOLLIN; // события, которых ждет epoll
+
+        size_t pendingOut() const { return out.size() - outSent; }
+    };
+
+    std::string socketPath;
+    std::string usersFile;
+    std::string resourcesFile;
+    std::unique_ptr<AccessControlSystem<>> system;
+
+    int listenFd = -1;
+    int epollFd = -1;
+    int signalFd = -1;
+    int reloadFd = -1; // eventfd: загрузка в фоне завершена
+    std::unordered_map<int, Connection> connections;
+
+    // Буферы разбора переиспользуются всеми запросами
+    std::vector<AccessQuery> queries;
+    std::vector<AccessResult> results;
+
+    std::thread loader;
+    std::unique_ptr<AccessControlSystem<>> loaded;
+    std::string loadError;
+
+    static std::unique_ptr<AccessControlSystem<>> load(const std::string& usersFile, const std::string& resourcesFile) {
+        auto result = std::make_unique<AccessControlSystem<>>();
+        auto errors = result->loadUsersFromFile(usersFile);
+        for (const auto& error : errors)
+            std::cerr << usersFile << ":" << error.line << ": " << error.message << "\n";
+        result->loadResourcesFromFile(resourcesFile);
+        return result;
+    }
+
+    void watch(int fd, uint32_t events, int op) {
+        epoll_event event{};
+        event.events = events;
+        event.data.fd = fd;
+        if (epoll_ctl(epollFd, op, fd, &event) != 0)
+            throw std::runtime_error("Ошибка epoll_ctl");
+    }
+
+    // Запуск фоновой загрузки; false, если загрузка уже идет
+    bool startReload() {
+        if (loader.joinable()) return false;
+        loader = std::thread([this] {
+            try {
+                loaded = load(usersFile, resourcesFile);
+            }
+            catch (const std::exception& e) {
+                loadError = e.what();
+            }
+            uint64_t one = 1;
+            (void)!write(reloadFd, &one, sizeof(one));
+        });
+        return true;
+    }
+
+    void finishReload() {
+        uint64_t value;
+        (void)!read(reloadFd, &value, sizeof(value));
+        loader.join();
+        if (loaded) {
+            system = std::move(loaded);
+            std::cout << "Данные перезагружены, пользователей: "
+                << system->read([](const auto& s) { return s.userCount(); }) << std::endl;
+        }
+        else {
+            std::cerr << "Ошибка перезагрузки: " << loadError << std::endl;
+        }
+    }
+
+    void closeConnection(int fd) {
+        epoll_ctl(epollFd, EPOLL_CTL_DEL, fd, nullptr);
+        close(fd);
+        connections.erase(fd);
+    }
+
+    // Отправка накопленных ответов; при заполнении сокета ждем EPOLLOUT,
+    // а при очереди выше daemonOutHighWater перестаем читать запросы
+    bool flush(Connection& c) {
+        while (c.outSent < c.out.size()) {
+            ssize_t n = send(c.fd, c.out.data() + c.outSent, c.out.size() - c.outSent, MSG_NOSIGNAL);
+            if (n < 0) {
+                if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+                if (errno == EINTR) continue;
+                return false;
+            }
+            c.outSent += static_cast<size_t>(n);
+        }
+        if (c.outSent == c.out.size()) {
+            c.out.clear();
+            c.outSent = 0;
+        }
+        uint32_t events = (c.pendingOut() < daemonOutHighWater ? EPOLLIN : 0u) | (c.out.empty() ? 0u : EPOLLOUT);
+        if (events != c.events) {
+            watch(c.fd, events, EPOLL_CTL_MOD);
+            c.events = events;
+        }
+        return true;
+    }
+
+    // Чтение запросов, пока очередь ответов ниже порога; кадры
+    // обрабатываются после каждого recv
+    bool serve(Connection& c) {
+        while (c.pendingOut() < daemonOutHighWater) {
+            // Буфер растет только под заголовок и тело текущего кадра
+            size_t need = 65536;
+            if (c.inUsed >= sizeof(DaemonFrameHeader)) {
+                DaemonFrameHeader header;
+                std::memcpy(&header, c.in.data(), sizeof(header));
+                need = std::max(need, sizeof(header) + header.size);
+            }
+            if (c.in.size() < need) c.in.resize(need);
+            if (c.inUsed == c.in.size()) return false;
+
+            ssize_t n = recv(c.fd, c.in.data() + c.inUsed, c.in.size() - c.inUsed, 0);
+            if (n == 0) return false;
+            if (n < 0) {
+                if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+                if (errno == EINTR) continue;
+                return false;
+            }
+            c.inUsed += static_cast<size_t>(n);
+            if (!processFrames(c)) return false;
+        }
+        return flush(c);
+    }
+
+    // Обработка всех полных кадров в буфере соединения
+    bool processFrames(Connection& c) {
+        size_t pos = 0;
+        while (c.inUsed - pos >= sizeof(DaemonFrameHeader)) {
+            DaemonFrameHeader header;
+            std::memcpy(&header, c.in.data() + pos, sizeof(header));
+            if (header.size > daemonMaxFrame) return false;
+            if (c.inUsed - pos - sizeof(header) < header.size) break;
+            const char* body = c.in.data() + pos + sizeof(header);
+
+            switch (static_cast<DaemonMessage>(header.type)) {
+            case DaemonMessage::Check:
+                if (!appendCheckReply(*system, body, header.size, queries, results, c.out)) return false;
+                break;
+            case DaemonMessage::Reload:
+                appendBytes(c.out, DaemonFrameHeader{ 1, header.type });
+                c.out.push_back(startReload() ? 1 : 0);
+                break;
+            default:
+                return false;
+            }
+            pos += sizeof(header) + header.size;
+        }
+        // Неполный кадр переносится в начало буфера
+        std::memmove(c.in.data(), c.in.data() + pos, c.inUsed - pos);
+        c.inUsed -= pos;
+        return true;
+    }
+
+public:
+    AccessDaemon(std::string socketPath, std::string usersFile, std::string resourcesFile)
+        : socketPath(std::move(socketPath)), usersFile(std::move(usersFile)), resourcesFile(std::move(resourcesFile)) {
+    }
+
+    AccessDaemon(const AccessDaemon&) = delete;
+    AccessDaemon& operator=(const AccessDaemon&) = delete;
+
+    ~AccessDaemon() {
+        if (loader.joinable()) loader.join();
+        for (auto& [fd, connection] : connections) close(fd);
+        for (int fd : { listenFd, epollFd, signalFd, reloadFd }) {
+            if (fd >= 0) close(fd);
+        }
+        if (listenFd >= 0) unlink(socketPath.c_str());
+    }
+
+    // Работа до SIGINT или SIGTERM; SIGHUP перезагружает данные
+    void run() {
+        // Сигналы принимаются через signalfd, поэтому блокируются до создания потоков
+        sigset_t signals;
+        sigemptyset(&signals);
+        sigaddset(&signals, SIGHUP);
+        sigaddset(&signals, SIGINT);
+        sigaddset(&signals, SIGTERM);
+        pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+
+        system = load(usersFile, resourcesFile);
+
+        sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+        if (socketPath.size() >= sizeof(address.sun_path))
+            throw std::invalid_argument("Слишком длинный путь сокета");
+        std::memcpy(address.sun_path, socketPath.c_str(), socketPath.size() + 1);
+
+        listenFd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (listenFd < 0)
+            throw std::runtime_error("Не удалось создать сокет");
+        unlink(socketPath.c_str());
+        if (bind(listenFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 || listen(listenFd, 128) != 0)
+            throw std::runtime_error("Не удалось открыть сокет " + socketPath);
+
+        epollFd = epoll_create1(EPOLL_CLOEXEC);
+        signalFd = signalfd(-1, &signals, SFD_NONBLOCK | SFD_CLOEXEC);
+        reloadFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (epollFd < 0 || signalFd < 0 || reloadFd < 0)
+            throw std::runtime_error("Не удалось создать дескрипторы событий");
+        watch(listenFd, EPOLLIN, EPOLL_CTL_ADD);
+        watch(signalFd, EPOLLIN, EPOLL_CTL_ADD);
+        watch(reloadFd, EPOLLIN, EPOLL_CTL_ADD);
+        std::cout << "Служба доступа слушает " << socketPath << std::endl;
+
+        epoll_event events[64];
+        bool running = true;
+        while (running) {
+            int count = epoll_wait(epollFd, events, 64, -1);
+            if (count < 0) {
+                if (errno == EINTR) continue;
+                throw std::runtime_error("Ошибка epoll_wait");
+            }
+            for (int i = 0; i < count; ++i) {
+                int fd = events[i].data.fd;
+                if (fd == listenFd) {
+                    int client;
+                    while ((client = accept4(listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC)) >= 0) {
+                        connections.emplace(client, Connection(client));
+                        watch(client, EPOLLIN, EPOLL_CTL_ADD);
+                    }
+                }
+                else if (fd == signalFd) {
+                    signalfd_siginfo info;
+                    while (read(signalFd, &info, sizeof(info)) == sizeof(info)) {
+                        if (info.ssi_signo == SIGHUP) startReload();
+                        else running = false;
+                    }
+                }
+                else if (fd == reloadFd) {
+                    finishReload();
+                }
+                else {
+                    auto it = connections.find(fd);
+                    if (it == connections.end()) continue;
+                    Connection& c = it->second;
+                    bool ok = !(events[i].events & (EPOLLERR | EPOLLHUP)) || (events[i].events & EPOLLIN);
+                    if (ok && (events[i].events & EPOLLIN)) ok = serve(c);
+                    if (ok && (events[i].events & EPOLLOUT)) ok = flush(c);
+                    if (!ok) closeConnection(fd);
+                }
+            }
+        }
+        std::cout << "Служба доступа остановлена" << std::endl;
+    }
+};
+
+// Клиент службы: блокирующее соединение с отправкой кадров без ожидания ответов
+class AccessDaemonClient {
+    int fd = -1;
+    std::vector<char> frame;
+
+public:
+    explicit AccessDaemonClient(const std::string& socketPath) {
+        sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+        if (socketPath.size() >= sizeof(address.sun_path))
+            throw std::invalid_argument("Слишком длинный путь сокета");
+        std::memcpy(address.sun_path, socketPath.c_str(), socketPath.size() + 1);
+        fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (fd < 0 || connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+            if (fd >= 0) close(fd);
+            throw std::runtime_error("Не удалось подключиться к службе " + socketPath);
+        }
+    }
+
+    ~AccessDaemonClient() { close(fd); }
+
+    AccessDaemonClient(const AccessDaemonClient&) = delete;
+    AccessDaemonClient& operator=(const AccessDaemonClient&) = delete;
+
+    // Отправка пакета проверок (ответ читается receiveCheck)
+    void sendCheck(std::span<const AccessQuery> batch) {
+        frame.clear();
+        appendCheckFrame(frame, batch);
+        sendAll(fd, frame.data(), frame.size());
+    }
+
+    void receiveCheck(std::span<AccessResult> results) {
+        DaemonFrameHeader header;
+        receiveAll(fd, reinterpret_cast<char*>(&header), sizeof(header));
+        if (header.type != static_cast<uint32_t>(DaemonMessage::Check) || header.size != results.size())
+            throw std::runtime_error("Неожиданный ответ службы");
+        receiveAll(fd, reinterpret_cast<char*>(results.data()), results.size());
+    }
+
+    // Запрос перезагрузки данных; false, если перезагрузка уже идет
+    bool reload() {
+        DaemonFrameHeader header{ 0, static_cast<uint32_t>(DaemonMessage::Reload) };
+        sendAll(fd, reinterpret_cast<const char*>(&header), sizeof(header));
+        receiveAll(fd, reinterpret_cast<char*>(&header), sizeof(header));
+        char accepted = 0;
+        receiveAll(fd, &accepted, 1);
+        return accepted == 1;
+    }
+};
+
+// Генератор нагрузки: requests пакетов по batchSize проверок случайных
+// пользователей [0, userCount) к ресурсу, до depth пакетов в полете.
+// Выводит p50/p99 задержки пакета и пропускную способность.
+void runDaemonLoad(const std::string& socketPath, const std::string& resourceName, int userCount,
+    size_t requests, size_t batchSize, size_t depth) {
+    AccessDaemonClient client(socketPath);
+    std::mt19937 rng(42);
+    std::vector<AccessQuery> batch(batchSize);
+    std::vector<AccessResult> results(batchSize);
+    std::vector<std::chrono::steady_clock::time_point> sentAt(requests);
+    std::vector<double> latencies(requests);
+    size_t allowed = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    size_t sent = 0, received = 0;
+    while (received < requests) {
+        while (sent < requests && sent - received < depth) {
+            for (auto& q : batch) q = { static_cast<int>(rng() % userCount), resourceName };
+            sentAt[sent] = std::chrono::steady_clock::now();
+            client.sendCheck(batch);
+            ++sent;
+        }
+        client.receiveCheck(results);
+        latencies[received] = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - sentAt[received]).count();
+        for (AccessResult r : results) allowed += r == AccessResult::Allowed;
+        ++received;
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::sort(latencies.begin(), latencies.end());
+    std::cout << "Пакетов: " << requests << " по " << batchSize << " проверок, в полете до " << depth << "\n"
+        << "Задержка пакета p50: " << latencies[requests / 2] << " мкс, p99: " << latencies[requests * 99 / 100] << " мкс\n"
+        << "Проверок в секунду: " << requests * batchSize / seconds << ", разрешено: " << allowed << "\n";
+}
+
+// Число потоков процесса по /proc/self/status; 0, если узнать не удалось
+inline size_t processThreadCount() {
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.starts_with("Threads:")) return std::stoul(line.substr(8));
+    }
+    return 0;
+}
+
+// Шардированная система: пользователи распределены по хешу id между
+// локальными рабочими процессами, ресурсы копируются в каждый. Маршрутизатор
+// отправляет каждому шарду его часть пакета по socketpair (кадры Check службы)
+// и собирает ответы в исходном порядке. Рабочие создаются через fork и
+// не используют пул потоков: его потоки в дочернем процессе не существуют.
+// Поэтому систему нужно создавать, пока процесс однопоточный (до пула,
+// писателя аудита и читающих потоков): замок, захваченный другим потоком
+// в момент fork (пул строк, malloc), в дочернем процессе не освободится.
+// Конструктор проверяет это и бросает std::logic_error.
+template<typename T = Resource>
+class ShardedAccessSystem {
+    struct Shard {
+        pid_t pid = -1;
+        int fd = -1;
+        std::vector<AccessQuery> queries;
+        std::vector<size_t> positions; // индексы запросов шарда в исходном пакете
+    };
+
+    static constexpr size_t maxBatch = 65536; // запросов на кадр одного шарда
+
+    std::vector<Shard> shards;
+    std::vector<char> frame;
+    std::vector<AccessResult> answers;
+
+    // Цикл рабочего процесса: загрузка своей части и ответы до закрытия сокета
+    [[noreturn]] static void serve(int fd, std::vector<UserRecord> users, const std::vector<T>& resources) {
+        int status = 0;
+        try {
+            AccessControlSystem<T> system;
+            typename AccessControlSystem<T>::WriteBatch batch;
+            batch.addUsers(std::move(users));
+            for (const auto& resource : resources) batch.addResource(resource);
+            system.apply(std::move(batch));
+
+            char ready = 1;
+            sendAll(fd, &ready, 1);
+
+            std::vector<char> in, out;
+            std::vector<AccessQuery> queries;
+            std::vector<AccessResult> results;
+            for (;;) {
+                DaemonFrameHeader header;
+                ssize_t n = recv(fd, &header, sizeof(header), MSG_PEEK);
+                if (n == 0) break; // маршрутизатор закрыл соединение
+                receiveAll(fd, reinterpret_cast<char*>(&header), sizeof(header));
+                if (header.type != static_cast<uint32_t>(DaemonMessage::Check) || header.size > daemonMaxFrame)
+                    throw std::runtime_error("Неверный кадр");
+                in.resize(header.size);
+                receiveAll(fd, in.data(), in.size());
+                out.clear();
+                if (!appendCheckReply(system, in.data(), in.size(), queries, results, out))
+                    throw std::runtime_error("Неверный кадр");
+                sendAll(fd, out.data(), out.size());
+            }
+        }
+        catch (const std::exception& e) {
+            std::cerr << "Шард: " << e.what() << std::endl;
+            status = 1;
+        }
+        _exit(status);
+    }
+
+    void stop() {
+        for (auto& shard : shards) {
+            if (shard.fd >= 0) close(shard.fd);
+            if (shard.pid > 0) waitpid(shard.pid, nullptr, 0);
+        }
+        shards.clear();
+    }
+
+    // Часть пакета: рассылка всем шардам, затем сбор ответов
+    void checkChunk(std::span<const AccessQuery> queries, std::span<AccessResult> results) {
+        for (auto& shard : shards) {
+            shard.queries.clear();
+            shard.positions.clear();
+        }
+        for (size_t i = 0; i < queries.size(); ++i) {
+            Shard& shard = shards[shardOf(queries[i].userId)];
+            shard.queries.push_back(queries[i]);
+            shard.positions.push_back(i);
+        }
+
+        for (auto& shard : shards) {
+            if (shard.queries.empty()) continue;
+            frame.clear();
+            appendCheckFrame(frame, shard.queries);
+            if (frame.size() - sizeof(DaemonFrameHeader) > daemonMaxFrame)
+                throw std::invalid_argument("Слишком большой пакет");
+            sendAll(shard.fd, frame.data(), frame.size());
+        }
+
+        for (auto& shard : shards) {
+            if (shard.queries.empty()) continue;
+            DaemonFrameHeader header;
+            receiveAll(shard.fd, reinterpret_cast<char*>(&header), sizeof(header));
+            if (header.type != static_cast<uint32_t>(DaemonMessage::Check) || header.size != shard.queries.size())
+                throw std::runtime_error("Неожиданный ответ шарда");
+            answers.resize(header.size);
+            receiveAll(shard.fd, reinterpret_cast<char*>(answers.data()), answers.size());
+            for (size_t j = 0; j < answers.size(); ++j) results[shard.positions[j]] = answers[j];
+        }
+    }
+
+public:
+    ShardedAccessSystem(size_t shardCount, const std::vector<UserRecord>& users, const std::vector<T>& resources) {
+        if (shardCount == 0)
+            throw std::invalid_argument("Число шардов должно быть положительным");
+        if (processThreadCount() > 1)
+            throw std::logic_error("Шарды создаются до запуска других потоков процесса");
+        shards.resize(shardCount);
+
+        std::vector<std::vector<UserRecord>> parts(shardCount);
+        for (const auto& record : users) parts[shardOf(record.id)].push_back(record);
+
+        std::cout.flush();
+        for (size_t i = 0; i < shardCount; ++i) {
+            int pair[2];
+            if (socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, pair) != 0) {
+                stop();
+                throw std::runtime_error("Не удалось создать socketpair");
+            }
+            pid_t pid = fork();
+            if (pid < 0) {
+                close(pair[0]);
+                close(pair[1]);
+                stop();
+                throw std::runtime_error("Не удалось создать процесс шарда");
+            }
+            if (pid == 0) {
+                // Шарду нужен только свой конец: унаследованные сокеты других
+                // шардов, в том числе других систем, не дали бы им увидеть
+                // закрытие соединения маршрутизатором
+                int fd = pair[1] == 3 ? 3 : dup2(pair[1], 3);
+                if (fd < 0) _exit(1);
+                close_range(4, ~0U, 0);
+                serve(fd, std::move(parts[i]), resources);
+            }
+            close(pair[1]);
+            shards[i].pid = pid;
+            shards[i].fd = pair[0];
+            parts[i] = {};
+        }
+
+        // Ожидание готовности: шард сообщает о завершении загрузки
+        try {
+            for (auto& shard : shards) {
+                char ready = 0;
+                receiveAll(shard.fd, &ready, 1);
+            }
+        }
+        catch (const std::exception&) {
+            stop();
+            throw std::runtime_error("Шард не смог загрузить данные");
+        }
+    }
+
+    ~ShardedAccessSystem() { stop(); }
+
+    ShardedAccessSystem(const ShardedAccessSystem&) = delete;
+    ShardedAccessSystem& operator=(const ShardedAccessSystem&) = delete;
+
+    size_t shardCount() const { return shards.size(); }
+
+    // Номер шарда-владельца пользователя (мультипликативный хеш id)
+    size_t shardOf(int userId) const {
+        uint64_t hash = static_cast<uint32_t>(userId) * 0x9E3779B97F4A7C15ull;
+        return static_cast<size_t>((hash >> 32) % shards.size());
+    }
+
+    // Пакетная проверка; результаты совпадают с AccessControlSystem::checkAccessBatch
+    void checkAccessBatch(std::span<const AccessQuery> queries, std::span<AccessResult> results) {
+        if (queries.size() != results.size())
+            throw std::invalid_argument("Размеры запросов и результатов не совпадают");
+        for (size_t i = 0; i < queries.size(); i += maxBatch) {
+            size_t count = std::min(maxBatch, queries.size() - i);
+            checkChunk(queries.subspan(i, count), results.subspan(i, count));
+        }
+    }
+
+    AccessResult tryCheckAccess(int userId, std::string_view resourceName) {
+        AccessQuery query{ userId, resourceName };
+        AccessResult result;
+        checkChunk({ &query, 1 }, { &result, 1 });
+        return result;
+    }
+};
+#endif
+
+// Вывод файла аудита в текстовом виде
+void dumpAuditFile(const std::string& filename) {
+    const char* verdicts[] = { "разрешен", "запрещен", "неизвестный пользователь", "неизвестный ресурс" };
+    auto records = AuditLog::readFile(filename);
+    for (const auto& r : records) {
+        std::cout << r.timestamp << " пользователь " << r.userId << " ресурс ";
+        if (r.resourceId == auditUnknownResource) std::cout << "?";
+        else std::cout << r.resourceId;
+        std::cout << ": " << (r.verdict < 4 ? verdicts[r.verdict] : "?") << "\n";
+    }
+    std::cout << "Записей: " << records.size() << "\n";
+}
+
+// Замер средней задержки checkAccess при разном числе пользователей
+void benchmarkCheckAccess() {
+    const size_t sizes[] = { 1000, 10000, 100000, 1000000, 10000000 };
+    const size_t queries = 1000000;
+    std::mt19937 rng(42);
+
+    std::cout << "=== checkAccess: задержка от числа пользователей ===\n";
+    for (size_t n : sizes) {
+        AccessControlSystem<> system;
+        AccessControlSystem<>::WriteBatch batch;
+        for (size_t i = 0; i < n; ++i) {
+            batch.addUser(std::make_unique<Student>("Студент", static_cast<int>(i), 1, "Группа101"));
+        }
+        batch.addResource(Resource("Лаборатория1", 2));
+        batch.addResource(Resource("Библиотека", 1));
+        system.apply(std::move(batch));
+
+        std::uniform_int_distribution<int> pick(0, static_cast<int>(n) - 1);
+        std::vector<int> ids(queries);
+        for (auto& id : ids) id = pick(rng);
+
+        size_t allowed = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (int id : ids) {
+            allowed += system.checkAccess(id, "Библиотека");
+        }
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        double ns = std::chrono::duration<double, std::nano>(elapsed).count() / queries;
+
+        std::cout << "Пользователей: " << n << ", среднее время checkAccess: "
+            << ns << " нс (разрешено: " << allowed << ")\n";
+    }
+}
+
+// Сравнение пакетной проверки с вызовом checkAccess в цикле
+void benchmarkCheckAccessBatch() {
+    const size_t userCount = 1000000;
+    const size_t queryCount = 4000000;
+    const std::string resourceNames[] = { "Лаборатория1", "Архив", "Библиотека" };
+
+    AccessControlSystem<> system;
+    AccessControlSystem<>::WriteBatch batch;
+    for (size_t i = 0; i < userCount; ++i) {
+        batch.addUser(std::make_unique<Student>("Студент", static_cast<int>(i), static_cast<int>(i % 5), "Группа101"));
+    }
+    batch.addResource(Resource("Лаборатория1", 2));
+    batch.addResource(Resource("Архив", 4));
+    batch.addResource(Resource("Библиотека", 1));
+    system.apply(std::move(batch));
+
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<int> pickUser(0, static_cast<int>(userCount) - 1);
+    std::uniform_int_distribution<int> pickResource(0, 2);
+    std::vector<AccessQuery> queries(queryCount);
+    for (auto& q : queries) q = { pickUser(rng), resourceNames[pickResource(rng)] };
+    std::vector<AccessResult> results(queryCount);
+
+    std::cout << "=== checkAccessBatch против checkAccess в цикле ===\n";
+
+    size_t allowedLoop = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (const auto& q : queries) {
+        allowedLoop += system.checkAccess(q.userId, std::string(q.resourceName));
+    }
+    double loopMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    start = std::chrono::steady_clock::now();
+    system.checkAccessBatch(queries, results);
+    double batchMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    size_t allowedBatch = std::count(results.begin(), results.end(), AccessResult::Allowed);
+
+    std::cout << "Запросов: " << queryCount << ", потоков в пуле: " << ThreadPool::shared().size() << "\n"
+        << "Цикл checkAccess: " << loopMs << " мс (разрешено: " << allowedLoop << ")\n"
+        << "checkAccessBatch: " << batchMs << " мс (разрешено: " << allowedBatch << ")\n"
+        << "Ускорение: " << loopMs / batchMs << "x\n";
+}
+
+// Память и задержка проверок через матрицу решений
+void benchmarkDecisionMatrix() {
+    const size_t userCount = 1000000;
+    const size_t resourceCount = 64;
+    const size_t queryCount = 4000000;
+
+    AccessControlSystem<> system;
+    AccessControlSystem<>::WriteBatch batch;
+    for (size_t i = 0; i < userCount; ++i) {
+        batch.addUser(std::make_unique<Student>("Студент", static_cast<int>(i), static_cast<int>(i % 10), "Группа101"));
+    }
+    std::vector<std::string> resourceNames;
+    for (size_t r = 0; r < resourceCount; ++r) {
+        resourceNames.push_back("Ресурс" + std::to_string(r));
+        batch.addResource(Resource(resourceNames.back(), static_cast<int>(r % 10)));
+    }
+    system.apply(std::move(batch));
+
+    std::mt19937 rng(3);
+    std::uniform_int_distribution<int> pickUser(0, static_cast<int>(userCount) - 1);
+    std::uniform_int_distribution<size_t> pickResource(0, resourceCount - 1);
+    std::vector<AccessQuery> queries(queryCount);
+    for (auto& q : queries) q = { pickUser(rng), resourceNames[pickResource(rng)] };
+
+    auto run = [&](const char* label) {
+        size_t allowed = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (const auto& q : queries)
+            allowed += system.tryCheckAccess(q.userId, q.resourceName) == AccessResult::Allowed;
+        double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / queryCount;
+        std::cout << label << ": " << ns << " нс на проверку (разрешено: " << allowed << ")\n";
+    };
+
+    std::cout << "=== Матрица решений: " << userCount << " пользователей x " << resourceCount << " ресурсов ===\n";
+    run("Без матрицы");
+
+    auto start = std::chrono::steady_clock::now();
+    system.enableDecisionMatrix();
+    double buildMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "Построение матрицы: " << buildMs << " мс, память: "
+        << system.decisionMatrixBytes() / 1024.0 / 1024.0 << " МБ\n";
+    run("С матрицей");
+
+    start = std::chrono::steady_clock::now();
+    for (int id = 0; id < 100000; ++id) system.setAccessLevel(id, 9 - id % 10);
+    double updateNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / 100000;
+    std::cout << "setAccessLevel с обновлением строки: " << updateNs << " нс\n";
+}
+
+// Холодная загрузка: текстовый формат против бинарного снимка
+void benchmarkSnapshotLoad() {
+    const size_t userCount = 1000000;
+    {
+        AccessControlSystem<> system;
+        AccessControlSystem<>::WriteBatch batch;
+        for (size_t i = 0; i < userCount; ++i) {
+            int id = static_cast<int>(i);
+            if (i % 3 == 0) batch.addUser(std::make_unique<Student>("Студент" + std::to_string(i), id, 1, "Группа101"));
+            else if (i % 3 == 1) batch.addUser(std::make_unique<Teacher>("Преподаватель" + std::to_string(i), id, 2, "Информатика"));
+            else batch.addUser(std::make_unique<Administrator>("Админ" + std::to_string(i), id, 5, "Кабинет200"));
+        }
+        batch.addResource(Resource("Лаборатория1", 2));
+        batch.addResource(Resource("Архив", 4));
+        system.apply(std::move(batch));
+        system.saveUsersToFile("bench_users.txt");
+        system.saveResourcesToFile("bench_resources.txt");
+        system.saveSnapshot("bench_snapshot.bin");
+    }
+
+    std::cout << "=== Загрузка " << userCount << " пользователей ===\n";
+    auto start = std::chrono::steady_clock::now();
+    {
+        AccessControlSystem<> system;
+        system.loadUsersFromFile("bench_users.txt");
+        system.loadResourcesFromFile("bench_resources.txt");
+    }
+    double textMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    start = std::chrono::steady_clock::now();
+    {
+        AccessControlSystem<> system;
+        system.loadSnapshot("bench_snapshot.bin");
+    }
+    double snapshotMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "Текстовые файлы: " << textMs << " мс\n"
+        << "Бинарный снимок: " << snapshotMs << " мс\n";
+}
+
+// Нагрузочная проверка чтения под параллельными изменениями:
+// писатель пакетами меняет уровни пары пользователей (всегда одинаково)
+// и добавляет новых, читатели проверяют, что видят согласованный снимок.
+// Выводится пропускная способность от 1 до N потоков-читателей.
+void benchmarkConcurrentReads() {
+    const int userCount = 100000;
+    const auto duration = std::chrono::milliseconds(1000);
+
+    AccessControlSystem<> system;
+    AccessControlSystem<>::WriteBatch batch;
+    for (int i = 0; i < userCount; ++i) {
+        batch.addUser(std::make_unique<Student>(i % 1000 == 0 ? "Иван" : "Студент", i, i % 5, "Группа101"));
+    }
+    batch.addResource(Resource("Лаборатория1", 2));
+    batch.addResource(Resource("Архив", 4));
+    system.apply(std::move(batch));
+
+    unsigned maxReaders = std::max(2u, std::thread::hardware_concurrency());
+    std::vector<std::pair<unsigned, double>> throughput;
+    size_t totalViolations = 0;
+    size_t totalPublished = 0;
+
+    std::cout << "=== Чтение при параллельной записи ===\n";
+    for (unsigned readerCount = 1; readerCount <= maxReaders; readerCount *= 2) {
+        std::atomic<bool> stop{ false };
+        std::atomic<size_t> checks{ 0 };
+        std::atomic<size_t> violations{ 0 };
+        size_t published = 0;
+
+        std::thread writer([&] {
+            int nextId = userCount + static_cast<int>(readerCount) * 1000000;
+            for (int round = 0; !stop.load(); ++round) {
+                AccessControlSystem<>::WriteBatch changes;
+                changes.setAccessLevel(0, round % 5);
+                changes.setAccessLevel(1, round % 5);
+                changes.addUser(std::make_unique<Student>("Новичок", nextId++, 1, "Группа102"));
+                system.apply(std::move(changes));
+                ++published;
+            }
+        });
+
+        std::vector<std::thread> readers;
+        for (unsigned r = 0; r < readerCount; ++r) {
+            readers.emplace_back([&, r] {
+                std::mt19937 rng(r);
+                std::uniform_int_distribution<int> pick(0, userCount - 1);
+                size_t local = 0;
+                while (!stop.load(std::memory_order_relaxed)) {
+                    system.read([&](const auto& s) {
+                        // Оба уровня меняются одним пакетом и должны совпадать
+                        if (s.findUserById(0)->getAccessLevel() != s.findUserById(1)->getAccessLevel())
+                            violations.fetch_add(1);
+                        for (int i = 0; i < 64; ++i) {
+                            if (s.tryCheckAccess(pick(rng), "Архив") == AccessResult::UnknownUser)
+                                violations.fetch_add(1);
+                        }
+                        if (local % 4096 == 0 && s.findUsersByName("Иван").size() != userCount / 1000)
+                            violations.fetch_add(1);
+                    });
+                    local += 64;
+                }
+                checks.fetch_add(local);
+            });
+        }
+
+        std::this_thread::sleep_for(duration);
+        stop.store(true);
+        for (auto& t : readers) t.join();
+        writer.join();
+
+        double perSecond = checks.load() / std::chrono::duration<double>(duration).count();
+        throughput.push_back({ readerCount, perSecond });
+        totalViolations += violations.load();
+        totalPublished += published;
+    }
+
+    double best = 0;
+    for (const auto& [readers, perSecond] : throughput) best = std::max(best, perSecond);
+    for (const auto& [readers, perSecond] : throughput) {
+        int bar = best > 0 ? static_cast<int>(40 * perSecond / best) : 0;
+        std::cout << "Читателей: " << readers << "\t" << static_cast<size_t>(perSecond) << " проверок/с\t"
+            << std::string(bar, '#') << "\n";
+    }
+    std::cout << "Опубликовано снимков: " << totalPublished
+        << ", нарушений согласованности: " << totalViolations << "\n";
+}
+
+// Объектная модель (unique_ptr<User> + dynamic_cast) против столбцового
+// хранилища на сортировке, поиске по имени и сохранении в файл
+void benchmarkColumnarUsers() {
+    const int userCount = 10000000;
+    auto elapsedMs = [](auto start) {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    };
+    auto makeUser = [](int i) -> std::unique_ptr<User> {
+        std::string name = i % 1000 == 0 ? "Иван" : "Пользователь";
+        if (i % 3 == 0) return std::make_unique<Student>(name, i, i % 7, "Группа101");
+        if (i % 3 == 1) return std::make_unique<Teacher>(name, i, i % 7, "Информатика");
+        return std::make_unique<Administrator>(name, i, i % 7, "Кабинет200");
+    };
+
+    std::cout << "=== " << userCount << " пользователей: объекты против столбцов ===\n";
+    {
+        std::vector<std::unique_ptr<User>> objects;
+        objects.reserve(userCount);
+        for (int i = 0; i < userCount; ++i) objects.push_back(makeUser(i));
+
+        auto start = std::chrono::steady_clock::now();
+        std::sort(objects.begin(), objects.end(),
+            [](const auto& a, const auto& b) { return a->getAccessLevel() < b->getAccessLevel(); });
+        double sortMs = elapsedMs(start);
+
+        start = std::chrono::steady_clock::now();
+        size_t found = 0;
+        for (const auto& u : objects) found += u->getName() == "Иван";
+        double findMs = elapsedMs(start);
+
+        start = std::chrono::steady_clock::now();
+        {
+            std::ofstream file("bench_objects.txt");
+            for (const auto& user : objects) {
+                if (auto s = dynamic_cast<Student*>(user.get()))
+                    file << "Student " << s->getName() << " " << s->getId() << " " << s->getAccessLevel() << " " << s->getGroup() << "\n";
+                else if (auto t = dynamic_cast<Teacher*>(user.get()))
+                    file << "Teacher " << t->getName() << " " << t->getId() << " " << t->getAccessLevel() << " " << t->getDepartment() << "\n";
+                else if (auto a = dynamic_cast<Administrator*>(user.get()))
+                    file << "Administrator " << a->getName() << " " << a->getId() << " " << a->getAccessLevel() << " " << a->getOffice() << "\n";
+            }
+        }
+        double saveMs = elapsedMs(start);
+        std::remove("bench_objects.txt");
+
+        std::cout << "Объекты:  сортировка " << sortMs << " мс, поиск по имени " << findMs
+            << " мс (найдено " << found << "), сохранение " << saveMs << " мс\n";
+    }
+    {
+        AccessControlSystem<> system;
+        AccessControlSystem<>::WriteBatch batch;
+        for (int i = 0; i < userCount; ++i) batch.addUser(makeUser(i));
+        system.apply(std::move(batch));
+
+        auto start = std::chrono::steady_clock::now();
+        system.sortByAccessLevel();
+        double sortMs = elapsedMs(start);
+
+        start = std::chrono::steady_clock::now();
+        size_t found = system.findUsersByName("Иван").size();
+        double findMs = elapsedMs(start);
+
+        start = std::chrono::steady_clock::now();
+        system.saveUsersToFile("bench_columns.txt");
+        double saveMs = elapsedMs(start);
+        std::remove("bench_columns.txt");
+
+        // Время сортировки включает ее применение к обоим экземплярам состояния
+        std::cout << "Столбцы:  сортировка " << sortMs << " мс, поиск по имени " << findMs
+            << " мс (найдено " << found << "), сохранение " << saveMs << " мс\n";
+    }
+}
+
+// Поиск по префиксу и точный поиск по имени через индекс имен
+void benchmarkNameIndex() {
+    const int userCount = 10000000;
+    const size_t queryCount = 100000;
+    const size_t limit = 10;
+
+    AccessControlSystem<> system;
+    AccessControlSystem<>::WriteBatch batch;
+    for (int i = 0; i < userCount; ++i) {
+        // Примерно 1 млн различных имен, по 10 пользователей на имя
+        batch.addUser(UserRecord{ UserType::Student, "Пользователь" + std::to_string(i % 1000000), i, 1, "Группа101" });
+    }
+    system.apply(std::move(batch));
+
+    std::mt19937 rng(11);
+    std::uniform_int_distribution<int> pick(0, 999999);
+    std::vector<std::string> prefixes(queryCount);
+    for (auto& p : prefixes) p = "Пользователь" + std::to_string(pick(rng)).substr(0, 3);
+
+    std::cout << "=== Индекс имен, " << userCount << " пользователей ===\n";
+    size_t found = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (const auto& p : prefixes) found += system.findUsersByPrefix(p, limit).size();
+    double prefixUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / queryCount;
+
+    start = std::chrono::steady_clock::now();
+    for (const auto& p : prefixes) found += system.completeName(p, limit).size();
+    double completeUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / queryCount;
+
+    std::vector<std::string> names(queryCount);
+    for (auto& n : names) n = "Пользователь" + std::to_string(pick(rng));
+    start = std::chrono::steady_clock::now();
+    for (const auto& n : names) system.forEachUserWithName(n, [&](const UserView&) { ++found; });
+    double exactUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / queryCount;
+
+    std::cout << "Префикс, первые " << limit << " пользователей: " << prefixUs << " мкс\n"
+        << "Автодополнение, " << limit << " имен: " << completeUs << " мкс\n"
+        << "Точный поиск по имени: " << exactUs << " мкс (всего найдено: " << found << ")\n";
+}
+
+// Запросы по уровням доступа через индекс против полной сортировки
+void benchmarkAccessLevelIndex() {
+    const int userCount = 1000000;
+    const int queryCount = 1000;
+
+    AccessControlSystem<> system;
+    AccessControlSystem<>::WriteBatch batch;
+    for (int i = 0; i < userCount; ++i) {
+        batch.addUser(UserRecord{ UserType::Student, "Студент", i, i % 100, "Группа101" });
+    }
+    system.apply(std::move(batch));
+
+    std::cout << "=== Индекс уровней доступа, " << userCount << " пользователей ===\n";
+
+    // Прежний способ: копия уровней, полная сортировка, поиск границы
+    std::vector<int> levels(userCount);
+    for (int i = 0; i < userCount; ++i) levels[i] = i % 100;
+    auto start = std::chrono::steady_clock::now();
+    size_t sortedCount = 0;
+    for (int q = 0; q < 10; ++q) {
+        std::vector<int> sorted = levels;
+        std::sort(sorted.begin(), sorted.end());
+        sortedCount += sorted.end() - std::lower_bound(sorted.begin(), sorted.end(), 98);
+    }
+    double sortUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / 10;
+
+    start = std::chrono::steady_clock::now();
+    size_t indexCount = 0;
+    long long idSum = 0;
+    for (int q = 0; q < queryCount; ++q) {
+        system.forEachUserWithAccessLevel(98, INT_MAX, [&](const UserView& user) {
+            ++indexCount;
+            idSum += user.getId();
+        });
+    }
+    double rangeUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / queryCount;
+
+    start = std::chrono::steady_clock::now();
+    size_t counted = 0;
+    for (int q = 0; q < queryCount; ++q) counted += system.countUsersWithAccessLevel(q % 100);
+    double countUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / queryCount;
+
+    std::cout << "Сортировка и поиск уровня >= 98: " << sortUs << " мкс (" << sortedCount / 10 << " польз.)\n"
+        << "Обход индекса для уровня >= 98: " << rangeUs << " мкс (" << indexCount / queryCount << " польз., сумма ID " << idSum / queryCount << ")\n"
+        << "Число пользователей уровня: " << countUs << " мкс (" << counted << ")\n";
+}
+
+// Стоимость записи в журнал аудита на пути проверки
+void benchmarkAudit() {
+    const int userCount = 100000;
+    const size_t queryCount = 4000000;
+
+    AccessControlSystem<> system;
+    AccessControlSystem<>::WriteBatch batch;
+    for (int i = 0; i < userCount; ++i) {
+        batch.addUser(UserRecord{ UserType::Student, "Студент", i, i % 5, "Группа101" });
+    }
+    batch.addResource(Resource("Архив", 4));
+    system.apply(std::move(batch));
+
+    auto run = [&] {
+        size_t allowed = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (size_t q = 0; q < queryCount; ++q)
+            allowed += system.tryCheckAccess(static_cast<int>(q % userCount), "Архив") == AccessResult::Allowed;
+        double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / queryCount;
+        return std::make_pair(ns, allowed);
+    };
+
+    std::cout << "=== Журнал аудита ===\n";
+    auto [plainNs, plainAllowed] = run();
+    system.enableAudit("bench_audit.bin");
+    AuditLog* log = system.audit();
+    log->attachThread();
+    auto [auditNs, auditAllowed] = run();
+    log->flush();
+    std::cout << "Без аудита: " << plainNs << " нс на проверку\n"
+        << "С аудитом: " << auditNs << " нс на проверку\n"
+        << "Записано: " << log->recordsWritten() << ", отброшено при переполнении: " << log->recordsDropped() << "\n";
+    system.disableAudit();
+    std::remove("bench_audit.bin");
+    (void)plainAllowed;
+    (void)auditAllowed;
+}
+
+// Параллельный разбор большого users.txt при разном числе потоков
+void benchmarkParallelLoad() {
+    const size_t userCount = 4000000;
+    {
+        std::ofstream file("bench_users_large.txt");
+        for (size_t i = 0; i < userCount; ++i) {
+            if (i % 3 == 0) file << "Student Студент" << i << " " << i << " 1 Группа101\n";
+            else if (i % 3 == 1) file << "Teacher Преподаватель" << i << " " << i << " 2 Информатика\n";
+            else file << "Administrator Админ" << i << " " << i << " 5 Кабинет200\n";
+        }
+        // Ошибочные строки в конце файла
+        file << "Guest Гость 1 1 Холл\nStudent Студент x 1 Группа101\nStudent Студент 7 -1 Группа101\n";
+    }
+
+    std::cout << "=== Параллельный разбор " << userCount << " строк ===\n";
+    double baseMs = 0;
+    size_t maxThreads = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<size_t> threadCounts;
+    for (size_t threads = 1; threads < maxThreads; threads *= 2) threadCounts.push_back(threads);
+    threadCounts.push_back(maxThreads);
+    for (size_t threads : threadCounts) {
+        ThreadPool pool(threads);
+        std::vector<LoadError> errors;
+        auto start = std::chrono::steady_clock::now();
+        auto users = AccessControlSystem<>::readUsersFile("bench_users_large.txt", errors, pool);
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        if (threads == 1) baseMs = ms;
+        std::cout << "Потоков: " << threads << ", " << ms << " мс, ускорение " << baseMs / ms
+            << ", пользователей " << users.size() << ", ошибок " << errors.size() << "\n";
+        if (threads == 1) {
+            for (const auto& error : errors) std::cout << "  строка " << error.line << ": " << error.message << "\n";
+        }
+    }
+    std::remove("bench_users_large.txt");
+}
+
+// Память на пользователя: строки в каждом столбце против общего пула строк.
+// Имена повторяются (50000 различных), групп 500 на миллион пользователей.
+void benchmarkStringInterning() {
+    const size_t userCount = 1000000;
+    std::vector<UserRecord> records;
+    records.reserve(userCount);
+    for (size_t i = 0; i < userCount; ++i) {
+        records.push_back({ UserType::Student, "Студент" + std::to_string(i % 50000), static_cast<int>(i), 1,
+            "Группа" + std::to_string(100 + i % 500) });
+    }
+
+    // Прежняя схема: std::string на каждое поле каждого пользователя
+    auto stringBytes = [](const std::string& value) {
+        bool local = value.data() >= reinterpret_cast<const char*>(&value)
+            && value.data() < reinterpret_cast<const char*>(&value + 1);
+        return sizeof(std::string) + (local ? 0 : value.capacity() + 1);
+    };
+    size_t stringColumns = 0;
+    {
+        std::vector<std::string> names, details;
+        names.reserve(userCount);
+        details.reserve(userCount);
+        for (const auto& record : records) {
+            names.push_back(record.name);
+            details.push_back(record.details);
+        }
+        for (size_t i = 0; i < userCount; ++i) stringColumns += stringBytes(names[i]) + stringBytes(details[i]);
+    }
+    size_t numericColumns = userCount * (2 * sizeof(int) + sizeof(UserType));
+
+    size_t poolBefore = StringPool::global().bytes();
+    UserColumns columns;
+    columns.reserve(userCount);
+    for (const auto& record : records) columns.push_back(record);
+    size_t poolBytes = StringPool::global().bytes() - poolBefore;
+
+    std::cout << "=== Интернирование строк (" << userCount << " пользователей) ===\n"
+        << "Байт на пользователя без пула: " << double(numericColumns + stringColumns) / userCount << "\n"
+        << "Байт на пользователя с пулом: " << double(columns.memoryBytes() + poolBytes) / userCount
+        << " (столбцы " << double(columns.memoryBytes()) / userCount
+        << ", пул " << double(poolBytes) / userCount << ")\n";
+}
+
+// Проверка доступа сравнением уровней (>=) и по маскам ролей (AND)
+// на одних и тех же случайных парах пользователь - ресурс
+void benchmarkRoleChecks() {
+    const size_t userCount = 1000000;
+    const size_t resourceCount = 64;
+    const size_t checkCount = 50000000;
+
+    std::mt19937 rng(42);
+    std::vector<int> levels(userCount);
+    std::vector<RoleMask> roles(userCount);
+    for (size_t i = 0; i < userCount; ++i) {
+        levels[i] = static_cast<int>(rng() % 6);
+        roles[i] = levelGrant(levels[i]);
+    }
+    std::vector<int> requiredLevels(resourceCount);
+    std::vector<RoleMask> requiredRoles(resourceCount);
+    for (size_t i = 0; i < resourceCount; ++i) {
+        requiredLevels[i] = static_cast<int>(rng() % 6);
+        requiredRoles[i] = levelRequirement(requiredLevels[i]);
+    }
+    std::vector<uint32_t> pairs(checkCount);
+    for (auto& p : pairs) p = rng();
+
+    auto measure = [&](auto check) {
+        size_t allowed = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (uint32_t p : pairs) allowed += check(p % userCount, p % resourceCount);
+        double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / checkCount;
+        return std::make_pair(ns, allowed);
+    };
+    auto [levelNs, levelAllowed] = measure([&](size_t u, size_t r) { return levels[u] >= requiredLevels[r]; });
+    auto [roleNs, roleAllowed] = measure([&](size_t u, size_t r) { return (roles[u] & requiredRoles[r]) != 0; });
+
+    std::cout << "=== Роли против уровней (" << checkCount << " проверок) ===\n"
+        << "Сравнение уровней: " << levelNs << " нс на проверку\n"
+        << "Маски ролей: " << roleNs << " нс на проверку\n"
+        << "Решения совпадают: " << (levelAllowed == roleAllowed ? "да" : "нет") << "\n";
+}
+
+// Сохранение одного изменения: перезапись users.txt против записи в журнал,
+// а также время фонового сворачивания и восстановления при запуске
+void benchmarkJournal() {
+    const int userCount = 1000000;
+    const int changeCount = 10000;
+    std::filesystem::remove_all("bench_journal");
+
+    std::cout << "=== Журнал изменений (" << userCount << " пользователей) ===\n";
+    {
+        AccessControlSystem<> system;
+        system.openJournal("bench_journal");
+        AccessControlSystem<>::WriteBatch batch;
+        for (int i = 0; i < userCount; ++i) {
+            batch.addUser(UserRecord{ UserType::Student, "Студент" + std::to_string(i), i, i % 5, "Группа101" });
+        }
+        batch.addResource(Resource("Архив", 4));
+        system.apply(std::move(batch));
+
+        auto start = std::chrono::steady_clock::now();
+        system.saveUsersToFile("bench_journal_users.txt");
+        double rewriteMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        std::remove("bench_journal_users.txt");
+
+        start = std::chrono::steady_clock::now();
+        system.compactJournal();
+        double rotateMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        // Изменения идут параллельно со сворачиванием
+        start = std::chrono::steady_clock::now();
+        for (int i = 0; i < changeCount; ++i) system.setAccessLevel(i, (i + 1) % 5);
+        double changeUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / changeCount;
+
+        start = std::chrono::steady_clock::now();
+        system.waitForCompaction();
+        double compactMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        std::cout << "Перезапись users.txt: " << rewriteMs << " мс\n"
+            << "Одно изменение с записью в журнал: " << changeUs << " мкс\n"
+            << "Переключение файла журнала: " << rotateMs << " мс, ожидание сворачивания: " << compactMs << " мс\n";
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    AccessControlSystem<> restored;
+    restored.openJournal("bench_journal");
+    double openMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "Запуск из снимка и хвоста журнала: " << openMs << " мс, пользователей "
+        << restored.read([](const auto& s) { return s.userCount(); })
+        << ", уровень пользователя 0: " << restored.findUserById(0)->accessLevel << "\n";
+    restored.closeJournal();
+    std::filesystem::remove_all("bench_journal");
+}
+
+// Зачисление миллиона пользователей: addUser в цикле против addUsers,
+// смена уровня группе: setAccessLevel по каждому против setAccessLevelWhere
+void benchmarkBulkOperations() {
+    const int userCount = 1000000;
+    const int groupCount = 100;
+    const int rounds = 10; // смена уровня группе повторяется, чередуя 3 и 4
+    std::vector<UserRecord> records;
+    records.reserve(userCount);
+    for (int i = 0; i < userCount; ++i) {
+        records.push_back({ UserType::Student, "Студент" + std::to_string(i), i, 1,
+            "Группа" + std::to_string(100 + i % groupCount) });
+    }
+
+    std::cout << "=== Массовые операции (" << userCount << " пользователей) ===\n";
+    double perCallMs, groupPerCallMs;
+    {
+        AccessControlSystem<> system;
+        auto start = std::chrono::steady_clock::now();
+        for (const auto& record : records) system.addUser(record);
+        perCallMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        start = std::chrono::steady_clock::now();
+        for (int round = 0; round < rounds; ++round) {
+            for (int i = 0; i < userCount; i += groupCount) system.setAccessLevel(i, 3 + round % 2);
+        }
+        groupPerCallMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / rounds;
+    }
+
+    AccessControlSystem<> system;
+    auto start = std::chrono::steady_clock::now();
+    system.addUsers(records);
+    double bulkMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    size_t changed = 0;
+    start = std::chrono::steady_clock::now();
+    for (int round = 0; round < rounds; ++round)
+        changed = system.setAccessLevelWhere(UserFilter::group("Группа100"), 3 + round % 2);
+    double groupBulkMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / rounds;
+
+    std::cout << "addUser в цикле: " << perCallMs << " мс\n"
+        << "addUsers: " << bulkMs << " мс\n"
+        << "Уровень группе (" << changed << " чел.), setAccessLevel по одному: " << groupPerCallMs << " мс\n"
+        << "Уровень группе, setAccessLevelWhere: " << groupBulkMs << " мс\n";
+}
+
+#ifdef __linux__
+// Пропускная способность шардированной системы от числа рабочих процессов
+void benchmarkShardedSystem() {
+    const int userCount = 1000000;
+    const size_t queryCount = 4000000;
+    const std::string resourceNames[] = { "Лаборатория1", "Архив", "Библиотека" };
+
+    std::vector<UserRecord> users;
+    users.reserve(userCount);
+    for (int i = 0; i < userCount; ++i)
+        users.push_back({ UserType::Student, "Студент", i, i % 5, "Группа101" });
+    std::vector<Resource> resources = { Resource("Лаборатория1", 2), Resource("Архив", 4), Resource("Библиотека", 1) };
+
+    std::mt19937 rng(11);
+    std::uniform_int_distribution<int> pickUser(0, userCount + userCount / 100); // ~1% неизвестных
+    std::uniform_int_distribution<int> pickResource(0, 2);
+    std::vector<AccessQuery> queries(queryCount);
+    for (auto& q : queries) q = { pickUser(rng), resourceNames[pickResource(rng)] };
+
+    // Шарды всех конфигураций создаются до первого потока процесса:
+    // эталон ниже запускает пул
+    size_t maxShards = std::max(4u, std::thread::hardware_concurrency());
+    std::vector<std::unique_ptr<ShardedAccessSystem<>>> configurations;
+    for (size_t shardCount = 1; shardCount <= maxShards; shardCount *= 2)
+        configurations.push_back(std::make_unique<ShardedAccessSystem<>>(shardCount, users, resources));
+
+    // Эталон: одна система в текущем процессе
+    std::vector<AccessResult> expected(queryCount);
+    {
+        AccessControlSystem<> system;
+        system.addUsers(users);
+        for (const auto& resource : resources) system.addResource(resource);
+        system.checkAccessBatch(queries, expected);
+    }
+
+    std::cout << "=== Шардированная система (" << userCount << " пользователей, "
+        << queryCount << " проверок, ядер: " << std::thread::hardware_concurrency() << ") ===\n";
+    double baseline = 0;
+    std::vector<AccessResult> results(queryCount);
+    for (const auto& configuration : configurations) {
+        ShardedAccessSystem<>& sharded = *configuration;
+        size_t shardCount = sharded.shardCount();
+        auto start = std::chrono::steady_clock::now();
+        std::clock_t cpuStart = std::clock();
+        sharded.checkAccessBatch(queries, results);
+        double routerSeconds = static_cast<double>(std::clock() - cpuStart) / CLOCKS_PER_SEC;
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (shardCount == 1) baseline = seconds;
+
+        std::cout << "Шардов: " << shardCount << ", проверок в секунду: " << queryCount / seconds
+            << ", ускорение: " << baseline / seconds << "x, маршрутизатор занят "
+            << 100 * routerSeconds / seconds << "%"
+            << (results == expected ? "" : " (РЕЗУЛЬТАТЫ РАСХОДЯТСЯ)") << "\n";
+    }
+}
+#endif
+
+void runBenchmarks() {
+#ifdef __linux__
+    // Первым: шарды создаются через fork, пока в процессе нет других потоков
+    benchmarkShardedSystem();
+#endif
+    benchmarkCheckAccess();
+    benchmarkCheckAccessBatch();
+    benchmarkDecisionMatrix();
+    benchmarkSnapshotLoad();
+    benchmarkJournal();
+    benchmarkParallelLoad();
+    benchmarkConcurrentReads();
+    benchmarkColumnarUsers();
+    benchmarkStringInterning();
+    benchmarkNameIndex();
+    benchmarkAccessLevelIndex();
+    benchmarkBulkOperations();
+    benchmarkRoleChecks();
+    benchmarkAudit();
+}
+
+int main(int argc, char* argv[]) {
+    setlocale(LC_ALL, "ru");
+    // Запуск с ключом --bench выполняет только замеры производительности
+    if (argc > 1 && std::string(argv[1]) == "--bench") {
+        runBenchmarks();
+        return 0;
+    }
+    // Локальная служба проверки доступа (только Linux):
+    //   --daemon socket users.txt resources.txt
+    //   --daemon-load socket ресурс число_пользователей [пакетов [размер_пакета [в_полете]]]
+    //   --daemon-reload socket
+    if (argc >= 3 && std::string(argv[1]).starts_with("--daemon")) {
+        std::string mode = argv[1];
+        try {
+#ifdef __linux__
+            if (mode == "--daemon" && argc == 5) {
+                AccessDaemon daemon(argv[2], argv[3], argv[4]);
+                daemon.run();
+            }
+            else if (mode == "--daemon-load" && argc >= 5) {
+                // Все числа должны быть положительными: иначе деление на ноль,
+                // пустая статистика или ожидание ответа на неотправленный пакет
+                long long users = std::stoll(argv[4]);
+                long long requests = argc > 5 ? std::stoll(argv[5]) : 100000;
+                long long batch = argc > 6 ? std::stoll(argv[6]) : 64;
+                long long depth = argc > 7 ? std::stoll(argv[7]) : 8;
+                if (users <= 0 || users > INT_MAX || requests <= 0 || batch <= 0 || depth <= 0) {
+                    std::cerr << "Использование: --daemon-load socket ресурс число_пользователей"
+                        " [пакетов [размер_пакета [в_полете]]]; все числа больше 0\n";
+                    return 1;
+                }
+                runDaemonLoad(argv[2], argv[3], static_cast<int>(users), static_cast<size_t>(requests),
+                    static_cast<size_t>(batch), static_cast<size_t>(depth));
+            }
+            else if (mode == "--daemon-reload" && argc == 3) {
+                AccessDaemonClient client(argv[2]);
+                std::cout << (client.reload() ? "Перезагрузка начата" : "Перезагрузка уже идет") << "\n";
+            }
+            else {
+                std::cerr << "Неверные аргументы " << mode << "\n";
+                return 1;
+            }
+#else
+            std::cerr << "Режим " << mode << " доступен только в Linux\n";
+            return 1;
+#endif
+        }
+        catch (const std::exception& e) {
+            std::cerr << "Ошибка: " << e.what() << "\n";
+            return 1;
+        }
+        return 0;
+    }
+    // Просмотр журнала аудита: --audit-dump audit.bin
+    if (argc == 3 && std::string(argv[1]) == "--audit-dump") {
+        try {
+            dumpAuditFile(argv[2]);
+        }
+        catch (const std::exception& e) {
+            std::cerr << "Ошибка: " << e.what() << "\n";
+            return 1;
+        }
+        return 0;
+    }
+    // Конвертеры между текстовым форматом и бинарным снимком:
+    //   --to-snapshot users.txt resources.txt snapshot.bin
+    //   --to-text snapshot.bin users.txt resources.txt
+    if (argc == 5 && (std::string(argv[1]) == "--to-snapshot" || std::string(argv[1]) == "--to-text")) {
+        try {
+            if (std::string(argv[1]) == "--to-snapshot")
+                convertTextToSnapshot(argv[2], argv[3], argv[4]);
+            else
+                convertSnapshotToText(argv[2], argv[3], argv[4]);
+        }
+        catch (const std::exception& e) {
+            std::cerr << "Ошибка: " << e.what() << "\n";
+            return 1;
+        }
+        return 0;
+    }
+    try {
+        AccessControlSystem<> system;
+
+        // Добавление пользователей
+        system.addUser(std::make_unique<Student>("Иван", 1, 1, "Группа101"));
+        system.addUser(std::make_unique<Teacher>("Мария", 2, 2, "Информатика"));
+        system.addUser(std::make_unique<Administrator>("Ольга", 3, 5, "Кабинет200"));
+        system.addUser(std::make_unique<Student>("Иван", 4, 1, "Группа102")); // Еще один Иван
+
+        // Добавление ресурсов
+        system.addResource(Resource("Лаборатория1", 2));
+        system.addResource(Resource("Архив", 4));
+        system.addResource(Resource("Библиотека", 1));
+
+        // Сохранение данных
+        system.saveUsersToFile("users.txt");
+        system.saveResourcesToFile("resources.txt");
+
+        // Загрузка данных (можно закомментировать для теста)
+         AccessControlSystem<> newSystem;
+         newSystem.loadUsersFromFile("users.txt");
+         newSystem.printAllUsers();
+         newSystem.loadResourcesFromFile("resources.txt");
+         newSystem.printAllResources();
+
+        // Бинарный снимок тех же данных
+        system.saveSnapshot("snapshot.bin");
+        AccessControlSystem<> snapshotSystem;
+        snapshotSystem.loadSnapshot("snapshot.bin");
+        std::cout << "Загружено из снимка, доступ Ольги в Архив: "
+            << snapshotSystem.checkAccess(3, "Архив") << "\n";
+        // Поиск пользователей по имени
+        auto ivanUsers = system.findUsersByName("Иван");
+        std::cout << "Найдено пользователей с именем Иван: " << ivanUsers.size() << "\n";
+        for (const auto& user : ivanUsers) {
+            user.displayInfo();
+        }
+
+        // Запросы по уровням доступа без пересортировки
+        std::cout << "Пользователи по уровням:";
+        for (const auto& [level, count] : system.accessLevelCounts())
+            std::cout << " " << level << "->" << count;
+        std::cout << "\nУровень доступа от 2:\n";
+        system.forEachUserWithAccessLevel(2, INT_MAX, [](const UserView& user) { user.displayInfo(); });
+
+        // Автодополнение имени для интерфейса администратора
+        std::cout << "Имена на \"М\":";
+        for (const auto& name : system.completeName("М", 5)) std::cout << " " << name;
+        std::cout << "\n";
+
+        // Проверка доступа
+        std::cout << "Доступ Ивана в Лаборатория1: "
+            << system.checkAccess(1, "Лаборатория1") << "\n";
+        std::cout << "Доступ Марии в Архив: "
+            << system.checkAccess(2, "Архив") << "\n";
+
+        // Матрица решений: после включения проверки сводятся к проверке бита
+        system.enableDecisionMatrix();
+        system.setAccessLevel(2, 4);
+        std::cout << "Доступ Марии в Архив после повышения уровня: "
+            << system.checkAccess(2, "Архив") << "\n";
+
+        // Роли: в хранилище пускают с уровня 3 или библиотекаря
+        system.addResource(Resource("Хранилище", 3, roleBit(Role::Librarian)));
+        std::cout << "Доступ Ивана в Хранилище: " << system.checkAccess(1, "Хранилище") << "\n";
+        system.setRoles(1, roleBit(Role::Librarian));
+        std::cout << "Доступ Ивана-библиотекаря в Хранилище: " << system.checkAccess(1, "Хранилище") << "\n";
+
+        // Журнал изменений: изменения дописываются в каталог journal,
+        // сворачивание в снимок идет в фоне, новая система восстанавливается
+        // из снимка и хвоста журнала
+        std::filesystem::remove_all("journal");
+        {
+            AccessControlSystem<> journaled;
+            journaled.openJournal("journal");
+            journaled.addUser(std::make_unique<Student>("Петр", 10, 1, "Группа103"));
+            journaled.addResource(Resource("Архив", 4));
+            journaled.compactJournal();
+            journaled.setAccessLevel(10, 4);
+            journaled.setName(10, "Павел");
+            journaled.waitForCompaction();
+        }
+        AccessControlSystem<> restored;
+        restored.openJournal("journal");
+        std::cout << "Восстановлено из журнала:\n";
+        restored.printAllUsers();
+        std::cout << "Доступ Павла в Архив: " << restored.checkAccess(10, "Архив") << "\n";
+
+        // Пакетная проверка доступа без исключений (с записью в журнал аудита)
+        system.enableAudit("audit.bin");
+        const AccessQuery queries[] = { {3, "Архив"}, {1, "Архив"}, {42, "Архив"}, {2, "Склад"} };
+        AccessResult results[std::size(queries)];
+        system.checkAccessBatch(queries, results);
+        system.disableAudit();
+        const char* verdicts[] = { "разрешен", "запрещен", "неизвестный пользователь", "неизвестный ресурс" };
+        for (size_t i = 0; i < std::size(queries); ++i) {
+            std::cout << "Пакет: пользователь " << queries[i].userId << ", ресурс " << queries[i].resourceName
+                << ": " << verdicts[static_cast<int>(results[i])] << "\n";
+        }
+
+        // Вывод всех ресурсов
+        std::cout << "\nВсе ресурсы:\n";
+        system.printAllResources();
+
+        // Массовые изменения: новый поток студентов и повышение уровня группе
+        system.addUsers({
+            { UserType::Student, "Анна", 20, 1, "Группа103" },
+            { UserType::Student, "Борис", 21, 1, "Группа103" },
+            { UserType::Teacher, "Вера", 22, 2, "Физика" } });
+        size_t changed = system.setAccessLevelWhere(UserFilter::group("Группа103"), 2);
+        std::cout << "\nУровень 2 назначен студентам Группа103: " << changed << "\n";
+        system.printAllUsers();
+
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Ошибка: " << e.what() << "\n";
+    }
+
+    return 0;
 }
\ No newline at end of file
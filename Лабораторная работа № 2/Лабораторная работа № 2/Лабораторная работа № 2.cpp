@@ -1,80 +1,80 @@
-﻿#include <iostream>
-#include <string>
-
-class Character {
-private:
-    std::string name;
-    int health;
-    int attack;
-    int defense;
-
-public:
-    // Конструктор
-    Character(const std::string& n, int h, int a, int d)
-        : name(n), health(h), attack(a), defense(d) {
-        std::cout << "Character " << name << " created!\n";
-    }
-
-    // Деструктор
-    ~Character() {
-        std::cout << "Character " << name << " destroyed!\n";
-    }
-
-    void displayInfo() const {
-        std::cout << "Name: " << name << ", HP: " << health
-            << ", Attack: " << attack << ", Defense: " << defense << std::endl;
-    }
-};
-
-class Monster {
-private:
-    std::string name;
-    int health;
-    int attack;
-    int defense;
-
-public:
-    // Конструктор
-    Monster(const std::string& n, int h, int a, int d)
-        : name(n), health(h), attack(a), defense(d) {
-        std::cout << "Monster " << name << " created!\n";
-    }
-
-    // Деструктор
-    ~Monster() {
-        std::cout << "Monster " << name << " destroyed!\n";
-    }
-
-    void displayInfo() const {
-        std::cout << "Name: " << name << ", HP: " << health
-            << ", Attack: " << attack << ", Defense: " << defense << std::endl;
-    }
-};
-
-class Weapon {
-private:
-    std::string name;
-    int damage;
-    int weight;
-public:
-    Weapon(const std::string& n, int d, int w)
-        : name(n), damage(d), weight(w){ }
-
-    ~Weapon() {
-        std::cout << "Weapon " << name << " destroyed!\n";
-    }
-    void displayInfo() const {
-        std::cout << "Name: " << name << ", Damage: " << damage
-            << ", Weight: " << weight << std::endl;
-    }
-};
-
-int main() {
-    Weapon excalibur = Weapon("Excalibur", 100, 2);
-    Weapon zulfikar = Weapon("Zulfikar", 75, 3);
-
-    excalibur.displayInfo();
-    zulfikar.displayInfo();
-
-    return 0;
+﻿#include <iostream>
+#include <string>
+
+class Character {
+private:
+    std::string name;
+    int health;
+    int attack;
+    int defense;
+
+public:
+    // Конструктор
+    Character(const std::string& n, int h, int a, int d)
+        : name(n), health(h), attack(a), defense(d) {
+        std::cout << "Character " << name << " created!\n";
+    }
+
+    // Деструктор
+    ~Character() {
+        std::cout << "Character " << name << " destroyed!\n";
+    }
+
+    void displayInfo() const {
+        std::cout << "Name: " << name << ", HP: " << health
+            << ", Attack: " << attack << ", Defense: " << defense << std::endl;
+    }
+};
+
+class Monster {
+private:
+    std::string name;
+    int health;
+    int attack;
+    int defense;
+
+public:
+    // Конструктор
+    Monster(const std::string& n, int h, int a, int d)
+        : name(n), health(h), attack(a), defense(d) {
+        std::cout << "Monster " << name << " created!\n";
+    }
+
+    // Деструктор
+    ~Monster() {
+        std::cout << "Monster " << name << " destroyed!\n";
+    }
+
+    void displayInfo() const {
+        std::cout << "Name: " << name << ", HP: " << health
+            << ", Attack: " << attack << ", Defense: " << defense << std::endl;
+    }
+};
+
+class Weapon {
+private:
+    std::string name;
+    int damage;
+    int weight;
+public:
+    Weapon(const std::string& n, int d, int w)
+        : name(n), damage(d), weight(w){ }
+
+    ~Weapon() {
+        std::cout << "Weapon " << name << " destroyed!\n";
+    }
+    void displayInfo() const {
+        std::cout << "Name: " << name << ", Damage: " << damage
+            << ", Weight: " << weight << std::endl;
+    }
+};
+
+int main() {
+    Weapon excalibur = Weapon("Excalibur", 100, 2);
+    Weapon zulfikar = Weapon("Zulfikar", 75, 3);
+
+    excalibur.displayInfo();
+    zulfikar.displayInfo();
+
+    return 0;
 }
\ No newline at end of file
@@ -1,157 +1,426 @@
-﻿#include <iostream>
-#include <string>
-#include <vector>
-
-class Entity {
-protected:
-    std::string name; // Защищенное поле: имя
-    int health;      // Защищенное поле: здоровье
-
-public:
-    // Конструктор базового класса
-    Entity(const std::string& n, int h) : name(n), health(h) {}
-
-    // Метод для вывода информации
-    virtual void displayInfo() const {
-        std::cout << "Name: " << name << ", HP: " << health << std::endl;
-    }
-
-    int getHealth() const {
-        return health;
-    }
-
-    virtual ~Entity() {}
-};
-
-class Player : public Entity {
-private:
-    int experience; // Приватное поле: опыт
-
-public:
-    // Конструктор производного класса
-    Player(const std::string& n, int h, int exp)
-        : Entity(n, h), experience(exp) {
-    }
-
-    // Переопределение метода displayInfo
-    void displayInfo() const override {
-        Entity::displayInfo(); // Вызов метода базового класса
-        std::cout << "Experience: " << experience << std::endl;
-    }
-};
-
-class Enemy : public Entity {
-private:
-    std::string type; // Приватное поле: тип врага
-
-public:
-    // Конструктор производного класса
-    Enemy(const std::string& n, int h, const std::string& t)
-        : Entity(n, h), type(t) {
-    }
-
-    // Переопределение метода displayInfo
-    void displayInfo() const override {
-        Entity::displayInfo(); // Вызов метода базового класса
-        std::cout << "Type: " << type << std::endl;
-    }
-};
-
-template <typename T>
-class Queue {
-private:
-    std::vector<T> elements; // Вектор для хранения элементов очереди
-
-public:
-    // Добавление элемента в конец очереди
-    void push(const T& item) {
-        elements.push_back(item);
-    }
-
-    // Удаление и возврат первого элемента из очереди
-    T pop() {
-        if (isEmpty()) {
-            throw std::runtime_error("Queue is empty");
-        }
-        T frontItem = elements.front(); // Сохраняем первый элемент
-        elements.erase(elements.begin()); // Удаляем первый элемент
-        return frontItem;
-    }
-
-    // Получение первого элемента без удаления
-    T front() const {
-        if (isEmpty()) {
-            throw std::runtime_error("Queue is empty");
-        }
-        return elements.front();
-    }
-
-    // Проверка, пуста ли очередь
-    bool isEmpty() const {
-        return elements.empty();
-    }
-};
-
-template <typename T>
-class GameManager {
-private:
-    std::vector<T> entities;
-
-public:
-    void addEntity(const T& entity) {
-        if (entity->getHealth() <= 0) {
-            throw std::invalid_argument("Entity has invalid health");
-        }
-        entities.push_back(entity);
-    }
-
-    void displayAll() const {
-        for (const auto& entity : entities) {
-            entity->displayInfo();
-        }
-    }
-};
-
-int main() {
-    try {
-        GameManager<Entity*> manager;
-        manager.addEntity(new Player("Hero", -100, 0)); // Вызовет исключение
-    }
-    catch (const std::invalid_argument& e) {
-        std::cerr << "Error: " << e.what() << std::endl;
-    }
-
-    GameManager<Entity*> manager;
-    manager.addEntity(new Player("Hero", 100, 0));
-    manager.addEntity(new Enemy("Goblin", 50, "Goblin"));
-    manager.displayAll();
-    Queue<std::string> stringQueue;
-    stringQueue.push("Hello");
-    stringQueue.push("World");
-    stringQueue.push("!");
-
-    std::cout << "String Queue:" << std::endl;
-    while (!stringQueue.isEmpty()) {
-        std::cout << stringQueue.pop() << std::endl;
-    }
-
-    Queue<int> intQueue;
-    intQueue.push(10);
-    intQueue.push(20);
-    intQueue.push(30);
-
-    std::cout << "\nInteger Queue:" << std::endl;
-    while (!intQueue.isEmpty()) {
-        std::cout << intQueue.pop() << std::endl;
-    }
-
-    // Проверка обработки пустой очереди
-    try {
-        intQueue.pop();
-    }
-    catch (const std::runtime_error& e) {
-        std::cout << "\nError: " << e.what() << std::endl;
-    }
-
-    return 0;
+﻿#include <iostream>
+#include <string>
+#include <vector>
+#include <stdexcept>
+#include <cstdint>
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <memory>
+
+// Часто используемые поля сущности для хранилища EntityStore
+struct EntityRecord {
+    int health = 0;
+    int attack = 0;
+    int defense = 0;
+    int level = 0;
+    int experience = 0;
+};
+
+// Хранилище часто используемых полей сущностей в виде структуры массивов:
+// каждое поле лежит в своем непрерывном массиве по номеру сущности. Имена,
+// типы и вывод остаются в объектах. Массовые проходы идут по массивам без
+// обращения к объектам и виртуальным функциям.
+class EntityStore {
+private:
+    std::vector<int> health;
+    std::vector<int> attack;
+    std::vector<int> defense;
+    std::vector<int> level;
+    std::vector<int> experience;
+
+public:
+    using Id = size_t;
+
+    Id add(const EntityRecord& record) {
+        health.push_back(record.health);
+        attack.push_back(record.attack);
+        defense.push_back(record.defense);
+        level.push_back(record.level);
+        experience.push_back(record.experience);
+        return health.size() - 1;
+    }
+
+    void reserve(size_t count) {
+        health.reserve(count);
+        attack.reserve(count);
+        defense.reserve(count);
+        level.reserve(count);
+        experience.reserve(count);
+    }
+
+    size_t size() const { return health.size(); }
+
+    int getHealth(Id id) const { return health[id]; }
+    int getAttack(Id id) const { return attack[id]; }
+    int getDefense(Id id) const { return defense[id]; }
+    int getLevel(Id id) const { return level[id]; }
+    int getExperience(Id id) const { return experience[id]; }
+
+    // Урон одной сущности с учетом защиты
+    void damage(Id id, int amount) {
+        health[id] -= std::max(0, amount - defense[id]);
+    }
+
+    // Урон всем сущностям с учетом защиты каждой
+    void damageAll(int amount) {
+        int* h = health.data();
+        const int* d = defense.data();
+        for (size_t i = 0, n = health.size(); i < n; ++i) {
+            h[i] -= std::max(0, amount - d[i]);
+        }
+    }
+
+    // Лечение всех живых сущностей; погибшие остаются погибшими
+    void healAll(int amount) {
+        int* h = health.data();
+        for (size_t i = 0, n = health.size(); i < n; ++i) {
+            h[i] += h[i] > 0 ? amount : 0;
+        }
+    }
+
+    size_t countAlive() const {
+        size_t alive = 0;
+        for (int h : health) {
+            alive += h > 0;
+        }
+        return alive;
+    }
+};
+
+class Entity {
+protected:
+    std::string name; // Защищенное поле: имя
+    int health;      // Защищенное поле: здоровье
+    int attack;      // Защищенное поле: атака
+    int defense;     // Защищенное поле: защита
+
+    // Хранилище, в котором лежат часто используемые поля сущности после
+    // добавления в GameManager<Entity*>; поля объекта тогда не используются,
+    // поэтому наследники читают их через get-методы
+    EntityStore* store = nullptr;
+    EntityStore::Id storeId = 0;
+
+public:
+    // Конструктор базового класса
+    Entity(const std::string& n, int h, int a = 0, int d = 0)
+        : name(n), health(h), attack(a), defense(d) {}
+
+    // Копия получает текущие значения и не привязана к хранилищу
+    Entity(const Entity& other)
+        : name(other.name), health(other.getHealth()), attack(other.getAttack()), defense(other.getDefense()) {}
+
+    Entity& operator=(const Entity&) = delete;
+
+    // Метод для вывода информации
+    virtual void displayInfo() const {
+        std::cout << "Name: " << name << ", HP: " << getHealth() << std::endl;
+    }
+
+    int getHealth() const {
+        return store ? store->getHealth(storeId) : health;
+    }
+
+    int getAttack() const { return store ? store->getAttack(storeId) : attack; }
+    int getDefense() const { return store ? store->getDefense(storeId) : defense; }
+
+    // Копия полей для EntityStore
+    virtual EntityRecord toRecord() const {
+        EntityRecord record;
+        record.health = getHealth();
+        record.attack = getAttack();
+        record.defense = getDefense();
+        return record;
+    }
+
+    // Перенос полей в хранилище под номером id и обратно в объект
+    void attach(EntityStore& target, EntityStore::Id id) {
+        store = &target;
+        storeId = id;
+    }
+
+    virtual void detach() {
+        health = getHealth();
+        attack = getAttack();
+        defense = getDefense();
+        store = nullptr;
+    }
+
+    bool isAttached() const { return store != nullptr; }
+
+    virtual ~Entity() {}
+};
+
+class Player : public Entity {
+private:
+    int experience; // Приватное поле: опыт
+    int level;      // Приватное поле: уровень
+
+public:
+    // Конструктор производного класса
+    Player(const std::string& n, int h, int exp, int lvl = 1, int a = 0, int d = 0)
+        : Entity(n, h, a, d), experience(exp), level(lvl) {
+    }
+
+    Player(const Player& other)
+        : Entity(other), experience(other.getExperience()), level(other.getLevel()) {
+    }
+
+    int getExperience() const { return store ? store->getExperience(storeId) : experience; }
+    int getLevel() const { return store ? store->getLevel(storeId) : level; }
+
+    EntityRecord toRecord() const override {
+        EntityRecord record = Entity::toRecord();
+        record.experience = getExperience();
+        record.level = getLevel();
+        return record;
+    }
+
+    void detach() override {
+        experience = getExperience();
+        level = getLevel();
+        Entity::detach();
+    }
+
+    // Переопределение метода displayInfo
+    void displayInfo() const override {
+        Entity::displayInfo(); // Вызов метода базового класса
+        std::cout << "Experience: " << getExperience() << std::endl;
+    }
+};
+
+class Enemy : public Entity {
+private:
+    std::string type; // Приватное поле: тип врага
+
+public:
+    // Конструктор производного класса
+    Enemy(const std::string& n, int h, const std::string& t, int a = 0, int d = 0)
+        : Entity(n, h, a, d), type(t) {
+    }
+
+    // Переопределение метода displayInfo
+    void displayInfo() const override {
+        Entity::displayInfo(); // Вызов метода базового класса
+        std::cout << "Type: " << type << std::endl;
+    }
+};
+
+template <typename T>
+class Queue {
+private:
+    std::vector<T> elements; // Вектор для хранения элементов очереди
+
+public:
+    // Добавление элемента в конец очереди
+    void push(const T& item) {
+        elements.push_back(item);
+    }
+
+    // Удаление и возврат первого элемента из очереди
+    T pop() {
+        if (isEmpty()) {
+            throw std::runtime_error("Queue is empty");
+        }
+        T frontItem = elements.front(); // Сохраняем первый элемент
+        elements.erase(elements.begin()); // Удаляем первый элемент
+        return frontItem;
+    }
+
+    // Получение первого элемента без удаления
+    T front() const {
+        if (isEmpty()) {
+            throw std::runtime_error("Queue is empty");
+        }
+        return elements.front();
+    }
+
+    // Проверка, пуста ли очередь
+    bool isEmpty() const {
+        return elements.empty();
+    }
+};
+
+template <typename T>
+class GameManager {
+private:
+    std::vector<T> entities;
+
+public:
+    void addEntity(const T& entity) {
+        if (entity->getHealth() <= 0) {
+            throw std::invalid_argument("Entity has invalid health");
+        }
+        entities.push_back(entity);
+    }
+
+    void displayAll() const {
+        for (const auto& entity : entities) {
+            entity->displayInfo();
+        }
+    }
+};
+
+// Менеджер указателей на сущности. Объекты остаются у вызывающего, как и
+// раньше, а их часто используемые поля переносятся в EntityStore: массовые
+// проходы идут по массивам, вывод - через виртуальный displayInfo объекта.
+// При уничтожении менеджера значения возвращаются в объекты.
+template <>
+class GameManager<Entity*> {
+private:
+    std::vector<Entity*> entities;
+    EntityStore store;
+
+public:
+    GameManager() = default;
+    GameManager(const GameManager&) = delete;
+    GameManager& operator=(const GameManager&) = delete;
+
+    ~GameManager() {
+        for (Entity* entity : entities) {
+            entity->detach();
+        }
+    }
+
+    EntityStore::Id addEntity(Entity* entity) {
+        if (entity->getHealth() <= 0) {
+            throw std::invalid_argument("Entity has invalid health");
+        }
+        if (entity->isAttached()) {
+            throw std::invalid_argument("Entity is already managed");
+        }
+        entities.push_back(entity);
+        EntityStore::Id id;
+        try {
+            id = store.add(entity->toRecord());
+        }
+        catch (...) {
+            entities.pop_back();
+            throw;
+        }
+        entity->attach(store, id);
+        return id;
+    }
+
+    void displayAll() const {
+        for (const auto& entity : entities) {
+            entity->displayInfo();
+        }
+    }
+
+    void reserve(size_t count) {
+        entities.reserve(count);
+        store.reserve(count);
+    }
+
+    EntityStore& data() { return store; }
+    const EntityStore& data() const { return store; }
+};
+
+// Проверка живых сущностей: обход объектов в куче в случайном порядке
+// против прохода по массиву здоровья хранилища
+void benchmarkEntityStore() {
+    const size_t entityCount = 1000000;
+    const int repeats = 20;
+
+    std::mt19937 rng(6);
+    std::vector<std::unique_ptr<Entity>> owned;
+    owned.reserve(entityCount);
+    for (size_t i = 0; i < entityCount; ++i) {
+        if (i % 2 == 0) owned.push_back(std::make_unique<Player>("Hero", 100, 0, 1, 15, 5));
+        else owned.push_back(std::make_unique<Enemy>("Goblin", 50, "Goblin", 10, 2));
+    }
+    std::shuffle(owned.begin(), owned.end(), rng);
+
+    std::vector<std::unique_ptr<Entity>> copies;
+    copies.reserve(entityCount);
+    GameManager<Entity*> manager;
+    manager.reserve(entityCount);
+    for (const auto& entity : owned) {
+        manager.addEntity(entity.get());
+        // Отдельная копия в куче для обхода по указателям
+        if (auto player = dynamic_cast<const Player*>(entity.get())) copies.push_back(std::make_unique<Player>(*player));
+        else copies.push_back(std::make_unique<Enemy>(static_cast<const Enemy&>(*entity)));
+    }
+    std::shuffle(copies.begin(), copies.end(), rng);
+
+    auto measure = [&](auto pass) {
+        size_t result = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (int r = 0; r < repeats; ++r) result += pass();
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / repeats;
+        return std::make_pair(ms, result);
+    };
+
+    auto pointers = measure([&] {
+        size_t alive = 0;
+        for (const auto& entity : copies) alive += entity->getHealth() > 0;
+        return alive;
+    });
+    auto arrays = measure([&] { return manager.data().countAlive(); });
+
+    std::cout << "Entities: " << entityCount << std::endl
+        << "Alive check, pointers: " << pointers.first << " ms, arrays: " << arrays.first << " ms" << std::endl;
+    if (pointers.second != arrays.second) {
+        std::cout << "Mismatch: " << pointers.second << " vs " << arrays.second << std::endl;
+    }
+
+}
+
+int main(int argc, char* argv[]) {
+    // Замер проходов по хранилищу: --bench
+    if (argc > 1 && std::string(argv[1]) == "--bench") {
+        benchmarkEntityStore();
+        return 0;
+    }
+
+    try {
+        GameManager<Entity*> manager;
+        manager.addEntity(new Player("Hero", -100, 0)); // Вызовет исключение
+    }
+    catch (const std::invalid_argument& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+    }
+
+    GameManager<Entity*> manager;
+    Player* hero = new Player("Hero", 100, 0, 1, 15, 5);
+    manager.addEntity(hero);
+    manager.addEntity(new Enemy("Goblin", 50, "Goblin", 10, 2));
+    manager.displayAll();
+
+    // Массовые проходы по массивам хранилища видны и через объекты
+    manager.data().damageAll(30);
+    manager.data().healAll(10);
+    std::cout << "After damage 30 and heal 10, alive: " << manager.data().countAlive()
+        << ", hero HP: " << hero->getHealth() << std::endl;
+    manager.displayAll();
+    Queue<std::string> stringQueue;
+    stringQueue.push("Hello");
+    stringQueue.push("World");
+    stringQueue.push("!");
+
+    std::cout << "String Queue:" << std::endl;
+    while (!stringQueue.isEmpty()) {
+        std::cout << stringQueue.pop() << std::endl;
+    }
+
+    Queue<int> intQueue;
+    intQueue.push(10);
+    intQueue.push(20);
+    intQueue.push(30);
+
+    std::cout << "\nInteger Queue:" << std::endl;
+    while (!intQueue.isEmpty()) {
+        std::cout << intQueue.pop() << std::endl;
+    }
+
+    // Проверка обработки пустой очереди
+    try {
+        intQueue.pop();
+    }
+    catch (const std::runtime_error& e) {
+        std::cout << "\nError: " << e.what() << std::endl;
+    }
+
+    return 0;
 }
\ No newline at end of file
@@ -1,130 +1,1005 @@
-﻿#include <iostream>
-#include <string>
-#include <thread>
-#include <mutex>
-#include <chrono>
-
-// Класс персонажа
-class Character {
-private:
-    std::string name;
-    int health;
-    int attack;
-    int defense;
-
-public:
-    Character(const std::string& n, int h, int a, int d)
-        : name(n), health(h), attack(a), defense(d) {
-        std::cout << "Character " << name << " created! HP=" << health << "\n";
-    }
-
-    // Методы для безопасного доступа к здоровью
-    int getHealth() const { return health; }
-    void takeDamage(int dmg) { health -= dmg; }
-
-    int getAttack() const { return attack; }
-    int getDefense() const { return defense; }
-
-    void displayInfo() const {
-        std::cout << name
-            << " [HP=" << health
-            << ", ATK=" << attack
-            << ", DEF=" << defense
-            << "]\n";
-    }
-
-    const std::string& getName() const { return name; }
-};
-
-// Класс монстра
-class Monster {
-private:
-    std::string name;
-    int health;
-    int attack;
-    int defense;
-
-public:
-    Monster(const std::string& n, int h, int a, int d)
-        : name(n), health(h), attack(a), defense(d) {
-        std::cout << "Monster " << name << " created! HP=" << health << "\n";
-    }
-
-    int getHealth() const { return health; }
-    void takeDamage(int dmg) { health -= dmg; }
-
-    int getAttack() const { return attack; }
-    int getDefense() const { return defense; }
-
-    void displayInfo() const {
-        std::cout << name
-            << " [HP=" << health
-            << ", ATK=" << attack
-            << ", DEF=" << defense
-            << "]\n";
-    }
-
-    const std::string& getName() const { return name; }
-};
-
-// Мьютекс для синхронизации боя
-std::mutex battleMutex;
-
-// Функция, выполняемая в отдельном потоке: бой героя и монстра
-void battle(Character& hero, Monster& monster) {
-    while (true) {
-        {
-            std::lock_guard<std::mutex> lock(battleMutex);
-
-            // Проверяем, кто ещё жив
-            if (hero.getHealth() <= 0 || monster.getHealth() <= 0)
-                break;
-
-            // Герой атакует монстра
-            int damageToMonster = std::max(0, hero.getAttack() - monster.getDefense());
-            monster.takeDamage(damageToMonster);
-            std::cout << hero.getName() << " hits " << monster.getName()
-                << " for " << damageToMonster << " dmg. "
-                << monster.getName() << " HP=" << monster.getHealth() << "\n";
-
-            // Если монстр погиб — выход
-            if (monster.getHealth() <= 0) {
-                std::cout << monster.getName() << " is defeated!\n";
-                break;
-            }
-
-            // Монстр отвечает атакой
-            int damageToHero = std::max(0, monster.getAttack() - hero.getDefense());
-            hero.takeDamage(damageToHero);
-            std::cout << monster.getName() << " hits " << hero.getName()
-                << " for " << damageToHero << " dmg. "
-                << hero.getName() << " HP=" << hero.getHealth() << "\n";
-
-            if (hero.getHealth() <= 0) {
-                std::cout << hero.getName() << " is defeated!\n";
-                break;
-            }
-        }
-
-        // Пауза между раундами боя
-        std::this_thread::sleep_for(std::chrono::seconds(1));
-    }
-}
-
-int main() {
-    // Создаём героя и монстра
-    Character hero("Hero", 100, 20, 10);
-    Monster   monster("Orc", 80, 15, 5);
-
-    // Запускаем поток боя
-    std::thread battleThread(battle, std::ref(hero), std::ref(monster));
-
-    battleThread.join();
-
-    // Выводим итоговые параметры
-    std::cout << "\n=== Battle Result ===\n";
-    hero.displayInfo();
-    monster.displayInfo();
-
-    return 0;
-}
+﻿#include <iostream>
+#include <string>
+#include <thread>
+#include <mutex>
+#include <chrono>
+#include <vector>
+#include <array>
+#include <atomic>
+#include <random>
+#include <algorithm>
+#include <cstdint>
+#include <climits>
+#include <stdexcept>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <condition_variable>
+#include <ctime>
+
+// Класс персонажа
+class Character {
+private:
+    std::string name;
+    int health;
+    int attack;
+    int defense;
+    std::mutex mutex; // Защищает здоровье во время раунда боя
+
+public:
+    Character(const std::string& n, int h, int a, int d, bool announce = true)
+        : name(n), health(h), attack(a), defense(d) {
+        if (announce) {
+            std::cout << "Character " << name << " created! HP=" << health << "\n";
+        }
+    }
+
+    // Методы для безопасного доступа к здоровью
+    int getHealth() const { return health; }
+    void takeDamage(int dmg) { health -= dmg; }
+
+    int getAttack() const { return attack; }
+    int getDefense() const { return defense; }
+
+    void displayInfo() const {
+        std::cout << name
+            << " [HP=" << health
+            << ", ATK=" << attack
+            << ", DEF=" << defense
+            << "]\n";
+    }
+
+    const std::string& getName() const { return name; }
+    std::mutex& getMutex() { return mutex; }
+};
+
+// Класс монстра
+class Monster {
+private:
+    std::string name;
+    int health;
+    int attack;
+    int defense;
+    std::mutex mutex; // Защищает здоровье во время раунда боя
+
+public:
+    Monster(const std::string& n, int h, int a, int d, bool announce = true)
+        : name(n), health(h), attack(a), defense(d) {
+        if (announce) {
+            std::cout << "Monster " << name << " created! HP=" << health << "\n";
+        }
+    }
+
+    int getHealth() const { return health; }
+    void takeDamage(int dmg) { health -= dmg; }
+
+    int getAttack() const { return attack; }
+    int getDefense() const { return defense; }
+
+    void displayInfo() const {
+        std::cout << name
+            << " [HP=" << health
+            << ", ATK=" << attack
+            << ", DEF=" << defense
+            << "]\n";
+    }
+
+    const std::string& getName() const { return name; }
+    std::mutex& getMutex() { return mutex; }
+};
+
+// Один раунд боя под мьютексами обоих бойцов (std::lock исключает
+// взаимную блокировку боев с общим бойцом). false - бой окончен.
+bool battleRound(Character& hero, Monster& monster, bool verbose) {
+    std::lock(hero.getMutex(), monster.getMutex());
+    std::lock_guard<std::mutex> heroLock(hero.getMutex(), std::adopt_lock);
+    std::lock_guard<std::mutex> monsterLock(monster.getMutex(), std::adopt_lock);
+
+    // Проверяем, кто ещё жив
+    if (hero.getHealth() <= 0 || monster.getHealth() <= 0)
+        return false;
+
+    // Герой атакует монстра
+    int damageToMonster = std::max(0, hero.getAttack() - monster.getDefense());
+    monster.takeDamage(damageToMonster);
+    if (verbose) {
+        std::cout << hero.getName() << " hits " << monster.getName()
+            << " for " << damageToMonster << " dmg. "
+            << monster.getName() << " HP=" << monster.getHealth() << "\n";
+    }
+
+    // Если монстр погиб — выход
+    if (monster.getHealth() <= 0) {
+        if (verbose) std::cout << monster.getName() << " is defeated!\n";
+        return false;
+    }
+
+    // Монстр отвечает атакой
+    int damageToHero = std::max(0, monster.getAttack() - hero.getDefense());
+    hero.takeDamage(damageToHero);
+    if (verbose) {
+        std::cout << monster.getName() << " hits " << hero.getName()
+            << " for " << damageToHero << " dmg. "
+            << hero.getName() << " HP=" << hero.getHealth() << "\n";
+    }
+
+    if (hero.getHealth() <= 0) {
+        if (verbose) std::cout << hero.getName() << " is defeated!\n";
+        return false;
+    }
+    return true;
+}
+
+// Функция, выполняемая в отдельном потоке: бой героя и монстра
+void battle(Character& hero, Monster& monster) {
+    while (battleRound(hero, monster, true)) {
+        // Пауза между раундами боя
+        std::this_thread::sleep_for(std::chrono::seconds(1));
+    }
+}
+
+// ===== Расчет исхода боя =====
+// Без бонусов и лечения бой полностью определяется здоровьем, атакой
+// и защитой: урон за удар постоянен, и исход можно вычислить сразу.
+
+// Характеристики бойца
+struct CombatStats {
+    int health;
+    int attack;
+    int defense;
+};
+
+template<typename Unit>
+CombatStats statsOf(const Unit& unit) {
+    return { unit.getHealth(), unit.getAttack(), unit.getDefense() };
+}
+
+// Итог одного боя
+struct FightResult {
+    int rounds;       // число атак героя
+    int heroHealth;
+    int monsterHealth;
+};
+
+// Один бой до гибели одного из бойцов или до maxRounds раундов (ничья)
+inline FightResult simulateFight(const CombatStats& hero, const CombatStats& monster, int maxRounds) {
+    int toMonster = std::max(0, hero.attack - monster.defense);
+    int toHero = std::max(0, monster.attack - hero.defense);
+    int heroHealth = hero.health;
+    int monsterHealth = monster.health;
+    int rounds = 0;
+    while (rounds < maxRounds) {
+        ++rounds;
+        monsterHealth -= toMonster;
+        if (monsterHealth <= 0) break;
+        heroHealth -= toHero;
+        if (heroHealth <= 0) break;
+    }
+    return { rounds, heroHealth, monsterHealth };
+}
+
+// Тот же исход за O(1): каждой стороне нужно ceil(здоровье / урон) ударов.
+// Герой бьет первым, поэтому при равном числе ударов побеждает он; монстр
+// к этому моменту успевает ударить на раз меньше. Если никто не успевает
+// за maxRounds раундов - ничья после maxRounds полных раундов.
+// Совпадает с simulateFight при здоровье обоих не меньше 1.
+inline FightResult resolveFight(const CombatStats& hero, const CombatStats& monster, int maxRounds) {
+    const int64_t never = INT64_MAX;
+    int64_t toMonster = std::max(0, hero.attack - monster.defense);
+    int64_t toHero = std::max(0, monster.attack - hero.defense);
+    int64_t heroHits = toMonster > 0 ? (monster.health + toMonster - 1) / toMonster : never;
+    int64_t monsterHits = toHero > 0 ? (hero.health + toHero - 1) / toHero : never;
+
+    int64_t rounds, heroTaken;
+    if (heroHits <= monsterHits && heroHits <= maxRounds) {
+        rounds = heroHits;
+        heroTaken = heroHits - 1;
+    }
+    else if (monsterHits < heroHits && monsterHits <= maxRounds) {
+        rounds = monsterHits;
+        heroTaken = monsterHits;
+    }
+    else {
+        rounds = maxRounds;
+        heroTaken = maxRounds;
+    }
+    return { static_cast<int>(rounds), static_cast<int>(hero.health - heroTaken * toHero),
+        static_cast<int>(monster.health - rounds * toMonster) };
+}
+
+// ===== Планировщик боев с перехватом задач =====
+// Бои выполняются задачами на фиксированном наборе потоков. У каждого
+// потока своя очередь: владелец берет задачи с конца, простаивающие
+// потоки перехватывают их с начала чужих очередей. Бой в задаче идет
+// без пауз и вывода; бойцы защищены собственными мьютексами.
+
+// Исход боя
+enum class BattleOutcome { HeroWon, MonsterWon, Draw };
+
+struct BattleResult {
+    BattleOutcome outcome;
+    int rounds;
+    int heroHealth;
+    int monsterHealth;
+};
+
+// Бой до конца без пауз и вывода (пропуск боя): исход вычисляется
+// resolveFight и применяется к бойцам под их мьютексами. Результат тот же,
+// что у цикла battleRound; после maxRounds раундов - ничья.
+BattleResult resolveBattle(Character& hero, Monster& monster, int maxRounds = 1000) {
+    std::lock(hero.getMutex(), monster.getMutex());
+    std::lock_guard<std::mutex> heroLock(hero.getMutex(), std::adopt_lock);
+    std::lock_guard<std::mutex> monsterLock(monster.getMutex(), std::adopt_lock);
+
+    int rounds = 0;
+    if (hero.getHealth() > 0 && monster.getHealth() > 0) {
+        FightResult result = resolveFight(statsOf(hero), statsOf(monster), maxRounds);
+        hero.takeDamage(hero.getHealth() - result.heroHealth);
+        monster.takeDamage(monster.getHealth() - result.monsterHealth);
+        rounds = result.rounds;
+    }
+    BattleOutcome outcome = monster.getHealth() <= 0 ? BattleOutcome::HeroWon
+        : hero.getHealth() <= 0 ? BattleOutcome::MonsterWon : BattleOutcome::Draw;
+    return { outcome, rounds, hero.getHealth(), monster.getHealth() };
+}
+
+class BattleScheduler {
+private:
+    struct WorkerQueue {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    std::vector<std::unique_ptr<WorkerQueue>> queues;
+    std::vector<std::thread> threads;
+    std::atomic<size_t> pending{ 0 };   // задачи в очередях
+    std::atomic<size_t> idle{ 0 };      // спящие потоки
+    std::atomic<size_t> nextQueue{ 0 }; // очередь для задач извне
+    std::atomic<bool> stopping{ false };
+    std::mutex sleepMutex;
+    std::condition_variable wake;
+
+    // Номер потока планировщика, в котором выполняется код, или -1
+    static thread_local const BattleScheduler* currentScheduler;
+    static thread_local size_t currentIndex;
+
+    bool tryPop(size_t self, std::function<void()>& task) {
+        {
+            WorkerQueue& own = *queues[self];
+            std::lock_guard<std::mutex> lock(own.mutex);
+            if (!own.tasks.empty()) {
+                task = std::move(own.tasks.back());
+                own.tasks.pop_back();
+                return true;
+            }
+        }
+        for (size_t i = 1; i < queues.size(); ++i) {
+            WorkerQueue& victim = *queues[(self + i) % queues.size()];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (!victim.tasks.empty()) {
+                task = std::move(victim.tasks.front());
+                victim.tasks.pop_front();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void run(size_t index) {
+        currentScheduler = this;
+        currentIndex = index;
+        std::function<void()> task;
+        for (;;) {
+            if (tryPop(index, task)) {
+                --pending;
+                try {
+                    task();
+                }
+                catch (const std::exception& e) {
+                    std::cerr << "Battle task failed: " << e.what() << "\n";
+                }
+                task = nullptr;
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(sleepMutex);
+            ++idle;
+            wake.wait(lock, [this] { return pending > 0 || stopping; });
+            --idle;
+            if (stopping && pending == 0) return;
+        }
+    }
+
+public:
+    explicit BattleScheduler(unsigned threadCount = std::thread::hardware_concurrency()) {
+        threadCount = std::max(1u, threadCount);
+        for (unsigned i = 0; i < threadCount; ++i) queues.push_back(std::make_unique<WorkerQueue>());
+        for (unsigned i = 0; i < threadCount; ++i) threads.emplace_back(&BattleScheduler::run, this, i);
+    }
+
+    // Дожидается выполнения всех поставленных задач
+    ~BattleScheduler() {
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (auto& thread : threads) thread.join();
+    }
+
+    BattleScheduler(const BattleScheduler&) = delete;
+    BattleScheduler& operator=(const BattleScheduler&) = delete;
+
+    size_t size() const { return threads.size(); }
+
+    // Задача из потока планировщика попадает в его очередь, извне - по кругу
+    void submit(std::function<void()> task) {
+        size_t index = currentScheduler == this ? currentIndex : nextQueue++ % queues.size();
+        {
+            // pending растет под замком очереди: поток, укравший задачу,
+            // не уменьшит счетчик раньше, чем он увеличен
+            std::lock_guard<std::mutex> lock(queues[index]->mutex);
+            queues[index]->tasks.push_back(std::move(task));
+            ++pending;
+        }
+        if (idle > 0) {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+            wake.notify_one();
+        }
+    }
+
+    // Набор задач: очереди получают равные части, потоки будятся один раз
+    void submitAll(std::vector<std::function<void()>> tasks) {
+        size_t count = tasks.size();
+        for (size_t q = 0; q < queues.size(); ++q) {
+            size_t begin = count * q / queues.size(), end = count * (q + 1) / queues.size();
+            std::lock_guard<std::mutex> lock(queues[q]->mutex);
+            for (size_t i = begin; i < end; ++i) queues[q]->tasks.push_back(std::move(tasks[i]));
+            pending += end - begin;
+        }
+        if (idle > 0) {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+            wake.notify_all();
+        }
+    }
+
+    // Бой с результатом через future
+    std::future<BattleResult> submitBattle(Character& hero, Monster& monster) {
+        auto task = std::make_shared<std::packaged_task<BattleResult()>>(
+            [&hero, &monster] { return resolveBattle(hero, monster); });
+        std::future<BattleResult> result = task->get_future();
+        submit([task] { (*task)(); });
+        return result;
+    }
+
+    // Бой с обратным вызовом в потоке планировщика
+    void submitBattle(Character& hero, Monster& monster, std::function<void(const BattleResult&)> onDone) {
+        submit([&hero, &monster, onDone] { onDone(resolveBattle(hero, monster)); });
+    }
+
+    // Набор боев; onDone получает номер пары и результат
+    void submitBattles(const std::vector<std::pair<Character*, Monster*>>& pairs,
+        std::function<void(size_t, const BattleResult&)> onDone) {
+        std::vector<std::function<void()>> tasks;
+        tasks.reserve(pairs.size());
+        for (size_t i = 0; i < pairs.size(); ++i) {
+            Character* hero = pairs[i].first;
+            Monster* monster = pairs[i].second;
+            tasks.push_back([hero, monster, i, onDone] { onDone(i, resolveBattle(*hero, *monster)); });
+        }
+        submitAll(std::move(tasks));
+    }
+};
+
+thread_local const BattleScheduler* BattleScheduler::currentScheduler = nullptr;
+thread_local size_t BattleScheduler::currentIndex = 0;
+
+// Масштабирование планировщика: одинаковый набор боев на 1..64 потоках
+void benchmarkScheduler(size_t battles) {
+    std::cout << "=== Battle scheduler scaling (" << battles << " battles, hardware threads: "
+        << std::thread::hardware_concurrency() << ") ===\n";
+    double baseline = 0;
+    for (unsigned threadCount = 1; threadCount <= 64; threadCount *= 2) {
+        std::deque<Character> heroes;
+        std::deque<Monster> monsters;
+        std::vector<std::pair<Character*, Monster*>> pairs;
+        for (size_t i = 0; i < battles; ++i) {
+            heroes.emplace_back("Hero", 100 + static_cast<int>(i % 50), 20, 10, false);
+            monsters.emplace_back("Orc", 80 + static_cast<int>(i % 70), 18 + static_cast<int>(i % 13), 5, false);
+            pairs.emplace_back(&heroes.back(), &monsters.back());
+        }
+
+        std::atomic<size_t> heroWins{ 0 };
+        auto start = std::chrono::steady_clock::now();
+        {
+            // Деструктор планировщика дожидается всех боев (и пустого набора)
+            BattleScheduler scheduler(threadCount);
+            scheduler.submitBattles(pairs, [&](size_t, const BattleResult& result) {
+                if (result.outcome == BattleOutcome::HeroWon) ++heroWins;
+            });
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (threadCount == 1) baseline = seconds;
+        std::cout << "Threads: " << threadCount << ", battles per second: " << battles / seconds
+            << ", speedup: " << baseline / seconds << "x, hero wins: " << heroWins << "\n";
+    }
+}
+
+// ===== Движок раундов реального времени =====
+// Один поток ведет все бои: следующий раунд каждого боя ставится
+// в иерархическое колесо таймеров, поток спит до ближайшего тика.
+
+// Иерархическое колесо таймеров: 4 уровня по 64 ячейки. Уровень L
+// хранит записи со сроком от 64^L до 64^(L+1) тиков вперед; при обороте
+// младшего уровня ячейка старшего переносится вниз. Вставка и срабатывание
+// O(1), сроки дальше 64^4 тиков укорачиваются и переставляются при срабатывании.
+class TimerWheel {
+public:
+    static constexpr int levelBits = 6;
+    static constexpr int slots = 1 << levelBits;
+    static constexpr int levels = 4;
+
+private:
+    struct Entry {
+        uint64_t deadline;
+        uint32_t id;
+    };
+
+    std::array<std::array<std::vector<Entry>, slots>, levels> wheel;
+    std::vector<Entry> due; // сработавшие на текущем тике
+    uint64_t currentTick = 0;
+    size_t count = 0;
+
+    void place(const Entry& entry) {
+        uint64_t delta = entry.deadline > currentTick ? entry.deadline - currentTick : 0;
+        if (delta == 0) {
+            due.push_back(entry);
+            return;
+        }
+        const uint64_t horizon = (uint64_t(1) << (levelBits * levels)) - 1;
+        uint64_t target = currentTick + std::min(delta, horizon);
+        int level = 0;
+        while (level < levels - 1 && delta >= (uint64_t(1) << (levelBits * (level + 1)))) ++level;
+        wheel[level][(target >> (levelBits * level)) & (slots - 1)].push_back(entry);
+    }
+
+public:
+    uint64_t now() const { return currentTick; }
+    size_t size() const { return count; }
+
+    // Пустое колесо можно перевести сразу на нужный тик
+    void jumpTo(uint64_t tick) {
+        if (count == 0 && tick > currentTick) currentTick = tick;
+    }
+
+    // Текущий тик уже обработан, поэтому срок не позже now() округляется
+    // вверх: запись сработает на следующем advance (тик now() + 1)
+    void schedule(uint32_t id, uint64_t deadline) {
+        ++count;
+        place({ deadline, id });
+    }
+
+    // Ближайший тик, на котором advance может вызвать fire: занятая ячейка
+    // уровня 0 до конца его оборота или сам конец оборота, где переносятся
+    // старшие уровни (их сроки не раньше). До этого тика можно спать.
+    uint64_t nextEventTick() const {
+        if (!due.empty()) return currentTick + 1;
+        uint64_t turnEnd = (currentTick | (slots - 1)) + 1;
+        for (uint64_t tick = currentTick + 1; tick < turnEnd; ++tick) {
+            if (!wheel[0][tick & (slots - 1)].empty()) return tick;
+        }
+        return turnEnd;
+    }
+
+    // Переход на следующий тик; fire(id) вызывается для каждой записи,
+    // срок которой наступил. Внутри fire можно ставить новые записи.
+    template<typename Fire>
+    void advance(Fire&& fire) {
+        ++currentTick;
+        // Перенос старших уровней, чьи младшие разряды обернулись
+        for (int level = levels - 1; level >= 1; --level) {
+            uint64_t mask = (uint64_t(1) << (levelBits * level)) - 1;
+            if ((currentTick & mask) != 0) continue;
+            auto& slot = wheel[level][(currentTick >> (levelBits * level)) & (slots - 1)];
+            std::vector<Entry> moved;
+            moved.swap(slot);
+            for (const auto& entry : moved) place(entry);
+        }
+        auto& slot = wheel[0][currentTick & (slots - 1)];
+        due.insert(due.end(), slot.begin(), slot.end());
+        slot.clear();
+
+        std::vector<Entry> firing;
+        firing.swap(due);
+        for (const auto& entry : firing) {
+            if (entry.deadline > currentTick) {
+                place(entry); // укороченный дальний срок
+                continue;
+            }
+            --count;
+            fire(entry.id);
+        }
+    }
+};
+
+// Опоздание срабатывания тиков относительно расписания
+struct LatenessStats {
+    uint64_t rounds;
+    double meanUs;
+    double p50Us; // верхняя граница корзины
+    double p99Us;
+    double maxUs;
+};
+
+class BattleTicker {
+private:
+    struct Battle {
+        Character* hero;
+        Monster* monster;
+        uint64_t intervalTicks;
+        uint64_t deadline;
+        int rounds;
+        std::function<void(const BattleResult&)> onDone;
+    };
+
+    struct NewBattle {
+        Character* hero;
+        Monster* monster;
+        std::chrono::microseconds interval;
+        std::chrono::microseconds delay;
+        std::function<void(const BattleResult&)> onDone;
+    };
+
+    static constexpr int latencyBuckets = 32; // корзина i: до 2^i мкс
+
+    const std::chrono::microseconds resolution;
+    std::chrono::steady_clock::time_point start;
+    TimerWheel wheel;
+    std::vector<Battle> battles;
+    std::vector<uint32_t> freeIds;
+
+    std::mutex incomingMutex;
+    std::condition_variable incomingReady;
+    std::vector<NewBattle> incoming;
+    bool stopping = false;
+    std::atomic<size_t> active{ 0 };
+
+    std::array<std::atomic<uint64_t>, latencyBuckets> latency{};
+    std::atomic<uint64_t> latencyCount{ 0 };
+    std::atomic<uint64_t> latencySumUs{ 0 };
+    std::atomic<uint64_t> latencyMaxUs{ 0 };
+
+    std::thread engine;
+
+    std::chrono::steady_clock::time_point tickTime(uint64_t tick) const {
+        return start + resolution * static_cast<int64_t>(tick);
+    }
+
+    void recordLateness(uint64_t deadline) {
+        auto late = std::chrono::steady_clock::now() - tickTime(deadline);
+        uint64_t us = static_cast<uint64_t>(std::max<int64_t>(0,
+            std::chrono::duration_cast<std::chrono::microseconds>(late).count()));
+        int bucket = 0;
+        while (bucket < latencyBuckets - 1 && us >= (uint64_t(1) << bucket)) ++bucket;
+        latency[bucket].fetch_add(1, std::memory_order_relaxed);
+        latencyCount.fetch_add(1, std::memory_order_relaxed);
+        latencySumUs.fetch_add(us, std::memory_order_relaxed);
+        if (us > latencyMaxUs.load(std::memory_order_relaxed)) latencyMaxUs.store(us, std::memory_order_relaxed);
+    }
+
+    void fire(uint32_t id) {
+        Battle& b = battles[id];
+        recordLateness(b.deadline);
+        bool running = battleRound(*b.hero, *b.monster, false);
+        ++b.rounds;
+        if (running) {
+            b.deadline += b.intervalTicks; // от расписания, а не от факта: без накопления сдвига
+            wheel.schedule(id, b.deadline);
+            return;
+        }
+        if (b.onDone) {
+            BattleOutcome outcome = b.monster->getHealth() <= 0 ? BattleOutcome::HeroWon : BattleOutcome::MonsterWon;
+            b.onDone({ outcome, b.rounds, b.hero->getHealth(), b.monster->getHealth() });
+        }
+        b.onDone = nullptr;
+        freeIds.push_back(id);
+        --active;
+    }
+
+    void acceptIncoming(std::vector<NewBattle>& added) {
+        for (auto& n : added) {
+            uint32_t id;
+            if (!freeIds.empty()) {
+                id = freeIds.back();
+                freeIds.pop_back();
+            }
+            else {
+                id = static_cast<uint32_t>(battles.size());
+                battles.emplace_back();
+            }
+            uint64_t interval = std::max<uint64_t>(1, static_cast<uint64_t>(n.interval / resolution));
+            uint64_t first = wheel.now() + 1 + static_cast<uint64_t>(n.delay / resolution);
+            battles[id] = { n.hero, n.monster, interval, first, 0, std::move(n.onDone) };
+            wheel.schedule(id, first);
+        }
+        added.clear();
+    }
+
+    // Поток спит до ближайшего тика с записями (без боев - до нового боя)
+    // и просыпается раньше, если бой добавлен
+    void run() {
+        std::vector<NewBattle> added;
+        for (;;) {
+            {
+                std::unique_lock<std::mutex> lock(incomingMutex);
+                auto ready = [this] { return stopping || !incoming.empty(); };
+                if (wheel.size() == 0) incomingReady.wait(lock, ready);
+                else incomingReady.wait_until(lock, tickTime(wheel.nextEventTick()), ready);
+                if (stopping) return;
+                added.swap(incoming);
+            }
+
+            // Пустое (или опустевшее по ходу) колесо переходит к elapsed сразу,
+            // не проходя пустые тики простоя
+            uint64_t elapsed = static_cast<uint64_t>((std::chrono::steady_clock::now() - start) / resolution);
+            while (wheel.now() < elapsed && wheel.size() > 0) {
+                wheel.advance([this](uint32_t id) { fire(id); });
+            }
+            wheel.jumpTo(elapsed);
+            acceptIncoming(added);
+        }
+    }
+
+public:
+    explicit BattleTicker(std::chrono::microseconds tickResolution = std::chrono::milliseconds(1))
+        : resolution(tickResolution), start(std::chrono::steady_clock::now()) {
+        if (resolution.count() <= 0)
+            throw std::invalid_argument("Tick resolution must be positive");
+        engine = std::thread(&BattleTicker::run, this);
+    }
+
+    // Останавливает движок; незавершенные бои прерываются без обратного вызова
+    ~BattleTicker() {
+        {
+            std::lock_guard<std::mutex> lock(incomingMutex);
+            stopping = true;
+        }
+        incomingReady.notify_one();
+        engine.join();
+    }
+
+    BattleTicker(const BattleTicker&) = delete;
+    BattleTicker& operator=(const BattleTicker&) = delete;
+
+    // Бой с раундом каждые interval (округляется вниз до тиков, не меньше
+    // одного тика). Первый раунд на ближайшем тике, как в battle(), или
+    // через delay - так раунды множества боев не собираются в один тик.
+    // onDone вызывается в потоке движка.
+    void addBattle(Character& hero, Monster& monster, std::chrono::microseconds interval,
+        std::function<void(const BattleResult&)> onDone = nullptr,
+        std::chrono::microseconds delay = std::chrono::microseconds(0)) {
+        ++active;
+        {
+            std::lock_guard<std::mutex> lock(incomingMutex);
+            incoming.push_back({ &hero, &monster, interval, delay, std::move(onDone) });
+        }
+        incomingReady.notify_one();
+    }
+
+    size_t activeBattles() const { return active; }
+
+    LatenessStats lateness() const {
+        LatenessStats stats{};
+        stats.rounds = latencyCount.load();
+        if (stats.rounds == 0) return stats;
+        stats.meanUs = static_cast<double>(latencySumUs.load()) / stats.rounds;
+        stats.maxUs = static_cast<double>(latencyMaxUs.load());
+        uint64_t seen = 0;
+        bool p50 = false;
+        for (int i = 0; i < latencyBuckets; ++i) {
+            seen += latency[i].load();
+            if (!p50 && seen * 2 >= stats.rounds) {
+                stats.p50Us = static_cast<double>(uint64_t(1) << i);
+                p50 = true;
+            }
+            if (seen * 100 >= stats.rounds * 99) {
+                stats.p99Us = static_cast<double>(uint64_t(1) << i);
+                break;
+            }
+        }
+        return stats;
+    }
+};
+
+// Много одновременных боев реального времени на одном потоке движка
+void runTicker(size_t battleCount, int intervalMs, int seconds) {
+    std::deque<Character> heroes;
+    std::deque<Monster> monsters;
+    for (size_t i = 0; i < battleCount; ++i) {
+        // Урон 1 за удар: бои длятся дольше замера
+        heroes.emplace_back("Hero", 100000, 6, 5, false);
+        monsters.emplace_back("Orc", 100000, 6, 5, false);
+    }
+
+    BattleTicker ticker;
+    std::clock_t cpuStart = std::clock();
+    auto wallStart = std::chrono::steady_clock::now();
+    // Начала боев равномерно распределены по первому интервалу
+    for (size_t i = 0; i < battleCount; ++i) {
+        ticker.addBattle(heroes[i], monsters[i], std::chrono::milliseconds(intervalMs), nullptr,
+            std::chrono::microseconds(static_cast<int64_t>(i) * intervalMs * 1000 / static_cast<int64_t>(battleCount)));
+    }
+    std::this_thread::sleep_for(std::chrono::seconds(seconds));
+    double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+    double cpu = static_cast<double>(std::clock() - cpuStart) / CLOCKS_PER_SEC;
+
+    LatenessStats stats = ticker.lateness();
+    std::cout << "Battles: " << battleCount << ", round interval: " << intervalMs << " ms, time: " << wall << " s\n"
+        << "Rounds fired: " << stats.rounds << " (expected ~" << static_cast<uint64_t>(battleCount * wall * 1000 / intervalMs) << ")\n"
+        << "Tick lateness: mean " << stats.meanUs << " us, p50 <= " << stats.p50Us << " us, p99 <= "
+        << stats.p99Us << " us, max " << stats.maxUs << " us\n"
+        << "CPU load: " << 100 * cpu / wall << "%\n";
+}
+
+// ===== Безголовая симуляция боев =====
+// Тот же порядок ходов и формула урона, что в battle(), но без вывода,
+// пауз и мьютекса. Характеристики бойцов выбираются из диапазонов,
+// исход каждого боя вычисляется resolveFight.
+
+// Диапазон характеристик (границы включительно)
+struct StatRange {
+    CombatStats min;
+    CombatStats max;
+
+    void validate() const {
+        if (min.health < 1 || min.attack < 0 || min.defense < 0 ||
+            min.health > max.health || min.attack > max.attack || min.defense > max.defense)
+            throw std::invalid_argument("Invalid stat range");
+    }
+};
+
+// Сводная статистика серии боев
+struct SimulationReport {
+    static constexpr int buckets = 64; // последняя корзина гистограмм: buckets-1 и больше
+
+    uint64_t fights = 0;
+    uint64_t heroWins = 0;
+    uint64_t monsterWins = 0;
+    uint64_t draws = 0;
+    uint64_t totalRounds = 0;
+    std::array<uint64_t, buckets> rounds{};        // раундов до конца боя
+    std::array<uint64_t, buckets> heroDamage{};    // урон удара героя: число ударов
+    std::array<uint64_t, buckets> monsterDamage{}; // урон удара монстра: число ударов
+
+    void add(const CombatStats& hero, const CombatStats& monster, const FightResult& result) {
+        int toMonster = std::max(0, hero.attack - monster.defense);
+        int toHero = std::max(0, monster.attack - hero.defense);
+        bool heroWon = result.monsterHealth <= 0;
+        int monsterHits = heroWon ? result.rounds - 1 : result.rounds;
+
+        ++fights;
+        if (heroWon) ++heroWins;
+        else if (result.heroHealth <= 0) ++monsterWins;
+        else ++draws;
+        totalRounds += result.rounds;
+        ++rounds[std::min(result.rounds, buckets - 1)];
+        heroDamage[std::min(toMonster, buckets - 1)] += result.rounds;
+        monsterDamage[std::min(toHero, buckets - 1)] += monsterHits;
+    }
+
+    void merge(const SimulationReport& other) {
+        fights += other.fights;
+        heroWins += other.heroWins;
+        monsterWins += other.monsterWins;
+        draws += other.draws;
+        totalRounds += other.totalRounds;
+        for (int i = 0; i < buckets; ++i) {
+            rounds[i] += other.rounds[i];
+            heroDamage[i] += other.heroDamage[i];
+            monsterDamage[i] += other.monsterDamage[i];
+        }
+    }
+
+    // Корзина, до которой включительно набирается доля q значений
+    static int percentile(const std::array<uint64_t, buckets>& histogram, double q) {
+        uint64_t total = 0;
+        for (uint64_t count : histogram) total += count;
+        uint64_t target = static_cast<uint64_t>(q * total);
+        uint64_t seen = 0;
+        for (int i = 0; i < buckets; ++i) {
+            seen += histogram[i];
+            if (seen > target) return i;
+        }
+        return buckets - 1;
+    }
+
+    static double mean(const std::array<uint64_t, buckets>& histogram) {
+        uint64_t total = 0, sum = 0;
+        for (int i = 0; i < buckets; ++i) {
+            total += histogram[i];
+            sum += histogram[i] * i;
+        }
+        return total ? static_cast<double>(sum) / total : 0.0;
+    }
+
+    void print() const {
+        auto percent = [this](uint64_t n) { return fights ? 100.0 * n / fights : 0.0; };
+        std::cout << "Fights: " << fights << "\n"
+            << "Hero wins: " << percent(heroWins) << "%, monster wins: " << percent(monsterWins)
+            << "%, draws: " << percent(draws) << "%\n"
+            << "Rounds: mean " << (fights ? static_cast<double>(totalRounds) / fights : 0.0)
+            << ", p50 " << percentile(rounds, 0.5) << ", p99 " << percentile(rounds, 0.99) << "\n"
+            << "Hero damage per hit: mean " << mean(heroDamage) << ", p50 " << percentile(heroDamage, 0.5)
+            << ", p99 " << percentile(heroDamage, 0.99) << "\n"
+            << "Monster damage per hit: mean " << mean(monsterDamage) << ", p50 " << percentile(monsterDamage, 0.5)
+            << ", p99 " << percentile(monsterDamage, 0.99) << "\n";
+        std::cout << "Rounds distribution:\n";
+        for (int i = 0; i < buckets; ++i) {
+            if (rounds[i] == 0) continue;
+            std::cout << "  " << i << (i == buckets - 1 ? "+" : "") << ": " << percent(rounds[i]) << "%\n";
+        }
+    }
+};
+
+// Случайное число из [lo, hi] умножением со сдвигом (смещение пренебрежимо мало)
+inline int pickStat(std::mt19937_64& rng, int lo, int hi) {
+    uint64_t span = static_cast<uint64_t>(hi - lo) + 1;
+    return lo + static_cast<int>(((rng() >> 32) * span) >> 32);
+}
+
+inline CombatStats pickStats(std::mt19937_64& rng, const StatRange& range) {
+    return { pickStat(rng, range.min.health, range.max.health),
+        pickStat(rng, range.min.attack, range.max.attack),
+        pickStat(rng, range.min.defense, range.max.defense) };
+}
+
+// Серия fights боев на threads потоках. Бои делятся на пакеты, потоки
+// забирают пакеты из общего счетчика; генератор каждого пакета засевается
+// seed и номером пакета, поэтому итог не зависит от числа потоков.
+SimulationReport simulateFights(const StatRange& heroes, const StatRange& monsters, uint64_t fights,
+    uint64_t seed = 42, int maxRounds = 1000, unsigned threads = std::thread::hardware_concurrency()) {
+    const uint64_t batchSize = 65536;
+    heroes.validate();
+    monsters.validate();
+    if (maxRounds < 1)
+        throw std::invalid_argument("maxRounds must be positive");
+    threads = std::max(1u, threads);
+
+    uint64_t batches = (fights + batchSize - 1) / batchSize;
+    std::atomic<uint64_t> nextBatch{ 0 };
+    std::vector<SimulationReport> reports(threads);
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t] {
+            SimulationReport local;
+            for (uint64_t b = nextBatch++; b < batches; b = nextBatch++) {
+                std::mt19937_64 rng(seed + b);
+                uint64_t end = std::min(fights, (b + 1) * batchSize);
+                for (uint64_t i = b * batchSize; i < end; ++i) {
+                    CombatStats hero = pickStats(rng, heroes);
+                    CombatStats monster = pickStats(rng, monsters);
+                    local.add(hero, monster, resolveFight(hero, monster, maxRounds));
+                }
+            }
+            reports[t] = local;
+        });
+    }
+    for (auto& worker : workers) worker.join();
+
+    SimulationReport total;
+    for (const auto& report : reports) total.merge(report);
+    return total;
+}
+
+// Запуск симуляции с разбросом вокруг героя и монстра из main()
+void runSimulation(uint64_t fights, unsigned threads) {
+    StatRange heroes{ { 80, 15, 5 }, { 120, 25, 15 } };
+    StatRange monsters{ { 60, 10, 0 }, { 100, 20, 10 } };
+
+    auto start = std::chrono::steady_clock::now();
+    SimulationReport report = simulateFights(heroes, monsters, fights, 42, 1000, threads);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    report.print();
+    std::cout << "Threads: " << threads << ", time: " << seconds << " s, fights per second: "
+        << fights / seconds << "\n";
+}
+
+// Проверка resolveFight против пошаговых боев: случайные и граничные
+// характеристики сравниваются с simulateFight, часть - с циклом battleRound
+// на объектах, как в battle(). Возвращает число расхождений.
+size_t verifyResolver(uint64_t cases) {
+    const int maxRounds = 1000;
+    std::mt19937_64 rng(7);
+    size_t mismatches = 0;
+    auto check = [&](const CombatStats& hero, const CombatStats& monster, bool withObjects) {
+        FightResult fast = resolveFight(hero, monster, maxRounds);
+        FightResult slow = simulateFight(hero, monster, maxRounds);
+        bool same = fast.rounds == slow.rounds && fast.heroHealth == slow.heroHealth
+            && fast.monsterHealth == slow.monsterHealth;
+        if (withObjects) {
+            Character h("Hero", hero.health, hero.attack, hero.defense, false);
+            Monster m("Orc", monster.health, monster.attack, monster.defense, false);
+            int rounds = 0;
+            bool running = true;
+            while (rounds < maxRounds && running) {
+                running = battleRound(h, m, false);
+                ++rounds;
+            }
+            if (running || (h.getHealth() > 0 && m.getHealth() > 0)) rounds = maxRounds;
+            same = same && rounds == fast.rounds && h.getHealth() == fast.heroHealth
+                && m.getHealth() == fast.monsterHealth;
+        }
+        if (!same && mismatches++ < 10) {
+            std::cout << "Mismatch: hero " << hero.health << "/" << hero.attack << "/" << hero.defense
+                << ", monster " << monster.health << "/" << monster.attack << "/" << monster.defense << "\n";
+        }
+    };
+
+    // Граничные случаи: нулевой урон, ровно смертельный удар, ничьи;
+    // атака и защита монстра перебираются независимо от героя
+    for (int hp = 1; hp <= 10; ++hp)
+        for (int atk = 0; atk <= 6; ++atk)
+            for (int def = 0; def <= 6; ++def)
+                for (int mhp = 1; mhp <= 10; ++mhp)
+                    for (int matk = 0; matk <= 6; ++matk)
+                        for (int mdef = 0; mdef <= 6; ++mdef)
+                            check({ hp, atk, def }, { mhp, matk, mdef }, true);
+
+    for (uint64_t i = 0; i < cases; ++i) {
+        CombatStats hero{ pickStat(rng, 1, 5000), pickStat(rng, 0, 200), pickStat(rng, 0, 200) };
+        CombatStats monster{ pickStat(rng, 1, 5000), pickStat(rng, 0, 200), pickStat(rng, 0, 200) };
+        check(hero, monster, i % 100 == 0);
+    }
+    std::cout << "Checked: " << cases << " random fights and the edge grid, mismatches: " << mismatches << "\n";
+    return mismatches;
+}
+
+int main(int argc, char* argv[]) {
+    // Бои реального времени на колесе таймеров: --ticker [боев [интервал_мс [секунд]]]
+    if (argc > 1 && std::string(argv[1]) == "--ticker") {
+        runTicker(argc > 2 ? std::stoull(argv[2]) : 20000, argc > 3 ? std::stoi(argv[3]) : 100,
+            argc > 4 ? std::stoi(argv[4]) : 5);
+        return 0;
+    }
+    // Масштабирование планировщика боев: --bench-scheduler [боев]
+    if (argc > 1 && std::string(argv[1]) == "--bench-scheduler") {
+        benchmarkScheduler(argc > 2 ? std::stoull(argv[2]) : 200000);
+        return 0;
+    }
+    // Сверка быстрого расчета исхода с пошаговым боем: --verify-resolver [боев]
+    if (argc > 1 && std::string(argv[1]) == "--verify-resolver") {
+        return verifyResolver(argc > 2 ? std::stoull(argv[2]) : 1000000) == 0 ? 0 : 1;
+    }
+    // Безголовая симуляция: --simulate [боев [потоков]]
+    if (argc > 1 && std::string(argv[1]) == "--simulate") {
+        try {
+            uint64_t fights = argc > 2 ? std::stoull(argv[2]) : 100000000;
+            unsigned threads = argc > 3 ? static_cast<unsigned>(std::stoul(argv[3]))
+                : std::max(1u, std::thread::hardware_concurrency());
+            runSimulation(fights, threads);
+        }
+        catch (const std::exception& e) {
+            std::cerr << "Error: " << e.what() << "\n";
+            return 1;
+        }
+        return 0;
+    }
+
+    // Создаём героя и монстра
+    Character hero("Hero", 100, 20, 10);
+    Monster   monster("Orc", 80, 15, 5);
+
+    // Запускаем бой задачей планировщика; деструктор дожидается его конца
+    {
+        BattleScheduler scheduler(1);
+        scheduler.submit([&hero, &monster] { battle(hero, monster); });
+    }
+
+    // Выводим итоговые параметры
+    std::cout << "\n=== Battle Result ===\n";
+    hero.displayInfo();
+    monster.displayInfo();
+
+    return 0;
+}
@@ -1,224 +1,808 @@
-﻿#include <iostream>
-#include <string>
-#include <vector>
-#include <fstream>
-#include <stdexcept>
-#include <memory>
-#include <algorithm> // для std::find
-
-// Исключение при смерти персонажа
-class DeathException : public std::runtime_error {
-public:
-    DeathException(const std::string& msg) : std::runtime_error(msg) {}
-};
-
-// Шаблонный класс для записи логов в файл
-template <typename T>
-class Logger {
-private:
-    std::ofstream file;
-public:
-    Logger(const std::string& filename) {
-        file.open(filename, std::ios::app);
-        if (!file) throw std::runtime_error("Не удалось открыть лог-файл");
-    }
-    ~Logger() { if (file.is_open()) file.close(); }
-    void log(const T& entry) { file << entry << std::endl; }
-};
-
-// Базовый класс персонажа и монстра
-class Character {
-protected:
-    std::string name;
-    int health;
-    int attack;
-    int defense;
-    int level;
-    int experience;
-public:
-    Character(const std::string& n, int h, int a, int d)
-        : name(n), health(h), attack(a), defense(d), level(1), experience(0) {
-    }
-    virtual ~Character() = default;
-
-    void takeDamage(int dmg) {
-        health -= dmg;
-        if (health < 0) health = 0;
-    }
-    bool isDead() const { return health <= 0; }
-
-    void attackEnemy(Character& enemy, Logger<std::string>& logger) {
-        int dmg = attack - enemy.defense;
-        if (dmg <= 0) dmg = 1;
-        enemy.takeDamage(dmg);
-        logger.log(name + " атакует " + enemy.getName() + " на " + std::to_string(dmg));
-    }
-
-    void heal(int amount, Logger<std::string>& logger) {
-        health += amount;
-        if (health > 100) health = 100;
-        logger.log(name + " восстанавливает " + std::to_string(amount) + " HP");
-    }
-
-    void gainExp(int exp, Logger<std::string>& logger) {
-        experience += exp;
-        logger.log(name + " получает " + std::to_string(exp) + " опыта");
-        if (experience >= 100) {
-            level++;
-            experience -= 100;
-            logger.log(name + " повышает уровень до " + std::to_string(level));
-        }
-    }
-
-    virtual void showInfo() const {
-        std::cout << "Имя: " << name
-            << ", HP: " << health
-            << ", Атака: " << attack
-            << ", Защита: " << defense
-            << ", Уровень: " << level
-            << ", Опыт: " << experience << std::endl;
-    }
-
-    virtual void save(std::ofstream& fout) const {
-        fout << name << ' ' << health << ' ' << attack << ' ' << defense
-            << ' ' << level << ' ' << experience << '\n';
-    }
-    virtual void load(std::ifstream& fin) {
-        fin >> name >> health >> attack >> defense >> level >> experience;
-    }
-
-    const std::string& getName() const { return name; }
-    int getHealth() const { return health; }
-};
-
-class Monster : public Character {
-public:
-    using Character::Character;
-};
-
-class Goblin : public Monster { public: Goblin() : Monster("Гоблин", 30, 10, 5) {} };
-class Dragon : public Monster { public: Dragon() : Monster("Дракон", 200, 40, 20) {} };
-class Skeleton : public Monster { public: Skeleton() : Monster("Скелет", 50, 15, 10) {} };
-
-// Инвентарь
-class Inventory {
-private:
-    std::vector<std::string> items;
-public:
-    void add(const std::string& item) { items.push_back(item); }
-    void remove(const std::string& item) {
-        auto it = std::find(items.begin(), items.end(), item);
-        if (it != items.end()) items.erase(it);
-    }
-    void show() const {
-        std::cout << "Инвентарь:";
-        if (items.empty()) std::cout << " пуст";
-        for (const auto& i : items) std::cout << " " << i;
-        std::cout << std::endl;
-    }
-    bool has(const std::string& item) const {
-        return std::find(items.begin(), items.end(), item) != items.end();
-    }
-    void save(std::ofstream& fout) const {
-        fout << items.size() << '\n';
-        for (const auto& i : items) fout << i << '\n';
-    }
-    void load(std::ifstream& fin) {
-        size_t n; fin >> n; fin.ignore();
-        items.clear();
-        for (size_t i = 0; i < n; ++i) {
-            std::string it; std::getline(fin, it);
-            items.push_back(it);
-        }
-    }
-};
-
-class Game {
-private:
-    Character player;
-    Inventory inv;
-    Logger<std::string> log;
-
-    // Использовать зелье лечения
-    void usePotion() {
-        const std::string potion = "Health Potion";
-        if (inv.has(potion)) {
-            player.heal(20, log);
-            inv.remove(potion);
-            std::cout << "Вы использовали зелье. HP = " << player.getHealth() << std::endl;
-        }
-        else {
-            std::cout << "У вас нет зелья!" << std::endl;
-        }
-    }
-
-public:
-    Game(const std::string& name)
-        : player(name, 100, 20, 10), log("game.log") {
-        // Начальный предмет
-        inv.add("Health Potion");
-    }
-
-    void start() {
-        std::cout << "=== Добро пожаловать в RPG ===" << std::endl;
-        player.showInfo(); inv.show();
-    }
-
-    void battle(std::unique_ptr<Monster> m) {
-        std::cout << "Появился " << m->getName() << "!" << std::endl;
-        while (!player.isDead() && !m->isDead()) {
-            std::cout << "Выберите действие: 1) Атаковать 2) Зелье\n";
-            int choice; std::cin >> choice;
-            if (choice == 2) {
-                usePotion();
-            }
-            else {
-                player.attackEnemy(*m, log);
-            }
-            if (m->isDead()) break;
-            m->attackEnemy(player, log);
-            std::cout << "Ваше HP: " << player.getHealth() << std::endl;
-        }
-
-        if (!player.isDead()) {
-            std::cout << "Вы победили " << m->getName() << "!" << std::endl;
-            player.gainExp(50, log);
-            // шанс дропа
-            inv.add("Health Potion");
-            std::cout << "Вы получили Health Potion!" << std::endl;
-        }
-        else {
-            throw DeathException(player.getName() + " погиб!");
-        }
-    }
-
-    void save(const std::string& file) {
-        std::ofstream fout(file);
-        player.save(fout);
-        inv.save(fout);
-        std::cout << "Сохранено в " << file << std::endl;
-    }
-    void load(const std::string& file) {
-        std::ifstream fin(file);
-        if (!fin) { std::cerr << "Не удалось загрузить файл" << std::endl; return; }
-        player.load(fin); inv.load(fin);
-        std::cout << "Загружено из " << file << std::endl;
-    }
-};
-
-int main() {
-    setlocale(LC_ALL, "ru");
-    Game game("Герой");
-    game.start();
-    game.battle(std::make_unique<Goblin>());
-    game.save("save.txt");
-    Game game2("Герой"); game2.load("save.txt"); game2.start();
-    game2.battle(std::make_unique<Skeleton>());
-    try {
-        game2.battle(std::make_unique<Dragon>());
-    }
-    catch (const DeathException& e) {
-        std::cerr << e.what() << std::endl;
-    }
-    return 0;
+﻿#include <iostream>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <stdexcept>
+#include <memory>
+#include <algorithm> // для std::find
+#include <coroutine>
+#include <optional>
+#include <exception>
+#include <chrono>
+#include <utility>
+#include <cstdint>
+#include <span>
+#include <unordered_map>
+
+// Исключение при смерти персонажа
+class DeathException : public std::runtime_error {
+public:
+    DeathException(const std::string& msg) : std::runtime_error(msg) {}
+};
+
+// Шаблонный класс для записи логов в файл; пустое имя файла отключает лог
+template <typename T>
+class Logger {
+private:
+    std::ofstream file;
+public:
+    Logger(const std::string& filename) {
+        if (filename.empty()) return;
+        file.open(filename, std::ios::app);
+        if (!file) throw std::runtime_error("Не удалось открыть лог-файл");
+    }
+    ~Logger() { if (file.is_open()) file.close(); }
+    void log(const T& entry) { if (file.is_open()) file << entry << std::endl; }
+};
+
+// ===== Поток боевых событий =====
+// Бой записывает компактные двоичные события в буфер; текст на русском
+// или английском собирается только потребителями, которым он нужен.
+
+enum class CombatEventType : uint8_t { Attack, Heal, Experience, LevelUp, AutoBattle };
+
+// Особенность удара
+enum class CombatProc : uint8_t {
+    None,
+    MinimumDamage // атака не пробила защиту, нанесен минимальный урон 1
+};
+
+// Событие боя: 20 байт
+struct CombatEvent {
+    uint32_t actor;  // номер имени в CombatNames
+    uint32_t target; // для событий без цели совпадает с actor
+    int32_t amount;  // урон, лечение, опыт или число ударов автобоя
+    int32_t value;   // HP цели после события или новый уровень
+    CombatEventType type;
+    CombatProc proc;
+};
+
+enum class CombatLanguage { Russian, English };
+
+// Имена участников боев по номерам событий
+class CombatNames {
+private:
+    std::vector<std::string> names;
+    std::unordered_map<std::string, uint32_t> ids;
+public:
+    uint32_t intern(const std::string& name) {
+        auto it = ids.find(name);
+        if (it != ids.end()) return it->second;
+        uint32_t id = static_cast<uint32_t>(names.size());
+        names.push_back(name);
+        ids.emplace(name, id);
+        return id;
+    }
+    const std::string& name(uint32_t id) const { return names.at(id); }
+};
+
+// Текст события на выбранном языке
+std::string renderEvent(const CombatEvent& e, const CombatNames& names, CombatLanguage language) {
+    const std::string& actor = names.name(e.actor);
+    bool ru = language == CombatLanguage::Russian;
+    switch (e.type) {
+    case CombatEventType::Attack:
+        return ru ? actor + " атакует " + names.name(e.target) + " на " + std::to_string(e.amount)
+            : actor + " attacks " + names.name(e.target) + " for " + std::to_string(e.amount);
+    case CombatEventType::Heal:
+        return ru ? actor + " восстанавливает " + std::to_string(e.amount) + " HP"
+            : actor + " restores " + std::to_string(e.amount) + " HP";
+    case CombatEventType::Experience:
+        return ru ? actor + " получает " + std::to_string(e.amount) + " опыта"
+            : actor + " gains " + std::to_string(e.amount) + " experience";
+    case CombatEventType::LevelUp:
+        return ru ? actor + " повышает уровень до " + std::to_string(e.value)
+            : actor + " reaches level " + std::to_string(e.value);
+    case CombatEventType::AutoBattle:
+        return ru ? actor + " в автобое бьет " + names.name(e.target) + " ударов: " + std::to_string(e.amount)
+            + ", HP цели: " + std::to_string(e.value)
+            : actor + " hits " + names.name(e.target) + " " + std::to_string(e.amount)
+            + " times in auto-battle, target HP " + std::to_string(e.value);
+    }
+    return {};
+}
+
+// Потребитель пачек событий
+class CombatEventSink {
+public:
+    virtual ~CombatEventSink() = default;
+    virtual void consume(std::span<const CombatEvent> events, const CombatNames& names) = 0;
+};
+
+// Текстовый лог в файл через Logger
+class TextLogSink : public CombatEventSink {
+private:
+    Logger<std::string> logger;
+    CombatLanguage language;
+public:
+    TextLogSink(const std::string& filename, CombatLanguage lang = CombatLanguage::Russian)
+        : logger(filename), language(lang) {
+    }
+    void consume(std::span<const CombatEvent> events, const CombatNames& names) override {
+        for (const auto& e : events) logger.log(renderEvent(e, names, language));
+    }
+};
+
+// Буфер событий боя. Пачка передается потребителям при заполнении буфера
+// и по flush; без потребителей события просто отбрасываются.
+class CombatLog {
+private:
+    static constexpr size_t capacity = 4096;
+
+    CombatNames names;
+    std::vector<CombatEvent> events;
+    std::vector<std::unique_ptr<CombatEventSink>> sinks;
+
+public:
+    CombatLog() { events.reserve(capacity); }
+    ~CombatLog() { flush(); }
+
+    CombatLog(const CombatLog&) = delete;
+    CombatLog& operator=(const CombatLog&) = delete;
+
+    uint32_t actor(const std::string& name) { return names.intern(name); }
+    const CombatNames& actorNames() const { return names; }
+
+    void addSink(std::unique_ptr<CombatEventSink> sink) { sinks.push_back(std::move(sink)); }
+
+    void record(const CombatEvent& e) {
+        events.push_back(e);
+        if (events.size() == capacity) flush();
+    }
+
+    void flush() {
+        if (events.empty()) return;
+        for (auto& sink : sinks) sink->consume(events, names);
+        events.clear();
+    }
+};
+
+// Базовый класс персонажа и монстра
+class Character {
+protected:
+    std::string name;
+    int health;
+    int attack;
+    int defense;
+    int level;
+    int experience;
+    uint32_t eventId = 0; // номер имени в CombatLog
+public:
+    Character(const std::string& n, int h, int a, int d)
+        : name(n), health(h), attack(a), defense(d), level(1), experience(0) {
+    }
+    virtual ~Character() = default;
+
+    void takeDamage(int dmg) {
+        health -= dmg;
+        if (health < 0) health = 0;
+    }
+    bool isDead() const { return health <= 0; }
+
+    // Номер имени для событий; назначается журналом боя
+    void registerIn(CombatLog& log) { eventId = log.actor(name); }
+
+    void attackEnemy(Character& enemy, CombatLog& log) {
+        int dmg = attack - enemy.defense;
+        CombatProc proc = CombatProc::None;
+        if (dmg <= 0) {
+            dmg = 1;
+            proc = CombatProc::MinimumDamage;
+        }
+        enemy.takeDamage(dmg);
+        log.record({ eventId, enemy.eventId, dmg, enemy.health, CombatEventType::Attack, proc });
+    }
+
+    // Итог автобоя одним событием: hits ударов, после которых у enemy
+    // остается health HP
+    void autoAttack(Character& enemy, int hits, int health, CombatLog& log) {
+        enemy.takeDamage(enemy.health - health);
+        log.record({ eventId, enemy.eventId, hits, enemy.health, CombatEventType::AutoBattle, CombatProc::None });
+    }
+
+    void heal(int amount, CombatLog& log) {
+        health += amount;
+        if (health > 100) health = 100;
+        log.record({ eventId, eventId, amount, health, CombatEventType::Heal, CombatProc::None });
+    }
+
+    void gainExp(int exp, CombatLog& log) {
+        experience += exp;
+        log.record({ eventId, eventId, exp, experience, CombatEventType::Experience, CombatProc::None });
+        if (experience >= 100) {
+            level++;
+            experience -= 100;
+            log.record({ eventId, eventId, 0, level, CombatEventType::LevelUp, CombatProc::None });
+        }
+    }
+
+    virtual void showInfo(std::ostream& out = std::cout) const {
+        out << "Имя: " << name
+            << ", HP: " << health
+            << ", Атака: " << attack
+            << ", Защита: " << defense
+            << ", Уровень: " << level
+            << ", Опыт: " << experience << std::endl;
+    }
+
+    virtual void save(std::ofstream& fout) const {
+        fout << name << ' ' << health << ' ' << attack << ' ' << defense
+            << ' ' << level << ' ' << experience << '\n';
+    }
+    virtual void load(std::ifstream& fin) {
+        fin >> name >> health >> attack >> defense >> level >> experience;
+    }
+
+    const std::string& getName() const { return name; }
+    int getHealth() const { return health; }
+    int getAttack() const { return attack; }
+    int getDefense() const { return defense; }
+};
+
+// Исход боя, в котором игрок только атакует: урон за удар постоянен
+// (не меньше 1), поэтому число ударов до победы каждой стороны равно
+// ceil(здоровье / урон). Игрок бьет первым и при равенстве побеждает.
+struct FightForecast {
+    bool playerWins;
+    int rounds;        // ходов игрока
+    int playerHealth;  // после боя, не меньше 0
+    int monsterHealth;
+};
+
+inline FightForecast forecastFight(const Character& player, const Character& monster) {
+    if (player.isDead() || monster.isDead())
+        return { !player.isDead(), 0, player.getHealth(), monster.getHealth() };
+    int64_t toMonster = std::max(1, player.getAttack() - monster.getDefense());
+    int64_t toPlayer = std::max(1, monster.getAttack() - player.getDefense());
+    int64_t playerHits = (monster.getHealth() + toMonster - 1) / toMonster;
+    int64_t monsterHits = (player.getHealth() + toPlayer - 1) / toPlayer;
+    if (playerHits <= monsterHits)
+        return { true, static_cast<int>(playerHits),
+            static_cast<int>(player.getHealth() - (playerHits - 1) * toPlayer), 0 };
+    return { false, static_cast<int>(monsterHits), 0,
+        static_cast<int>(monster.getHealth() - monsterHits * toMonster) };
+}
+
+class Monster : public Character {
+public:
+    using Character::Character;
+};
+
+class Goblin : public Monster { public: Goblin() : Monster("Гоблин", 30, 10, 5) {} };
+class Dragon : public Monster { public: Dragon() : Monster("Дракон", 200, 40, 20) {} };
+class Skeleton : public Monster { public: Skeleton() : Monster("Скелет", 50, 15, 10) {} };
+
+// Инвентарь
+class Inventory {
+private:
+    std::vector<std::string> items;
+public:
+    void add(const std::string& item) { items.push_back(item); }
+    void remove(const std::string& item) {
+        auto it = std::find(items.begin(), items.end(), item);
+        if (it != items.end()) items.erase(it);
+    }
+    void show(std::ostream& out = std::cout) const {
+        out << "Инвентарь:";
+        if (items.empty()) out << " пуст";
+        for (const auto& i : items) out << " " << i;
+        out << std::endl;
+    }
+    bool has(const std::string& item) const {
+        return std::find(items.begin(), items.end(), item) != items.end();
+    }
+    void save(std::ofstream& fout) const {
+        fout << items.size() << '\n';
+        for (const auto& i : items) fout << i << '\n';
+    }
+    void load(std::ifstream& fin) {
+        size_t n; fin >> n; fin.ignore();
+        items.clear();
+        for (size_t i = 0; i < n; ++i) {
+            std::string it; std::getline(fin, it);
+            items.push_back(it);
+        }
+    }
+};
+
+// ===== Источники действий игрока и сопрограмма боя =====
+
+enum class PlayerAction { Attack = 1, Potion = 2, AutoBattle = 3 };
+
+// Действие по номеру пункта меню; неизвестный номер - атака
+inline PlayerAction actionFromChoice(int choice) {
+    if (choice == 2) return PlayerAction::Potion;
+    if (choice == 3) return PlayerAction::AutoBattle;
+    return PlayerAction::Attack;
+}
+
+// Состояние боя, доступное источнику действий (например, боту)
+struct BattleView {
+    int playerHealth;
+    int enemyHealth;
+    bool hasPotion;
+};
+
+// Источник действий игрока. Синхронный источник сразу возвращает действие
+// из tryNext; асинхронный возвращает nullopt, запоминает сопрограмму в
+// suspend и возобновляет ее, когда действие появится.
+class InputSource {
+public:
+    virtual ~InputSource() = default;
+    virtual std::optional<PlayerAction> tryNext(const BattleView& view) = 0;
+    virtual void suspend(std::coroutine_handle<> /*waiting*/) {
+        throw std::logic_error("Источник не поддерживает ожидание");
+    }
+    // Действие для возобновленной сопрограммы
+    virtual PlayerAction take() { return PlayerAction::Attack; }
+};
+
+// Ожидание действия: без приостановки, если источник ответил сразу
+struct ActionAwaiter {
+    InputSource& source;
+    BattleView view;
+    std::optional<PlayerAction> action;
+
+    bool await_ready() {
+        action = source.tryNext(view);
+        return action.has_value();
+    }
+    void await_suspend(std::coroutine_handle<> handle) { source.suspend(handle); }
+    PlayerAction await_resume() { return action ? *action : source.take(); }
+};
+
+inline ActionAwaiter nextAction(InputSource& source, const BattleView& view) {
+    return { source, view, std::nullopt };
+}
+
+// Ввод с консоли (блокирующий, как прежний std::cin >> choice)
+class ConsoleInput : public InputSource {
+public:
+    std::optional<PlayerAction> tryNext(const BattleView&) override {
+        int choice = 1;
+        std::cin >> choice;
+        return actionFromChoice(choice);
+    }
+};
+
+// Заранее записанный сценарий; после его конца - атака
+class ScriptedInput : public InputSource {
+private:
+    std::vector<PlayerAction> actions;
+    size_t position = 0;
+public:
+    explicit ScriptedInput(std::vector<PlayerAction> script) : actions(std::move(script)) {}
+
+    // Сценарий из файла: числа 1 (атака), 2 (зелье) и 3 (автобой) через пробелы
+    static ScriptedInput fromFile(const std::string& filename) {
+        std::ifstream fin(filename);
+        if (!fin) throw std::runtime_error("Не удалось открыть сценарий");
+        std::vector<PlayerAction> script;
+        int choice;
+        while (fin >> choice) script.push_back(actionFromChoice(choice));
+        return ScriptedInput(std::move(script));
+    }
+
+    std::optional<PlayerAction> tryNext(const BattleView&) override {
+        return position < actions.size() ? actions[position++] : PlayerAction::Attack;
+    }
+};
+
+// Бот: пьет зелье при низком здоровье, иначе атакует
+class BotInput : public InputSource {
+private:
+    int potionThreshold;
+public:
+    explicit BotInput(int threshold = 30) : potionThreshold(threshold) {}
+
+    std::optional<PlayerAction> tryNext(const BattleView& view) override {
+        return view.hasPotion && view.playerHealth < potionThreshold ? PlayerAction::Potion : PlayerAction::Attack;
+    }
+};
+
+// Асинхронный источник: действия приходят извне (например, из сокета,
+// читаемого циклом событий) через push, который возобновляет бой
+class QueuedInput : public InputSource {
+private:
+    std::coroutine_handle<> waiting;
+    std::optional<PlayerAction> received;
+public:
+    std::optional<PlayerAction> tryNext(const BattleView&) override {
+        std::optional<PlayerAction> action = received;
+        received.reset();
+        return action;
+    }
+    void suspend(std::coroutine_handle<> handle) override { waiting = handle; }
+    PlayerAction take() override {
+        PlayerAction action = received.value_or(PlayerAction::Attack);
+        received.reset();
+        return action;
+    }
+
+    bool isWaiting() const { return static_cast<bool>(waiting); }
+
+    // Передать действие; ожидающий бой продолжается до следующего хода
+    void push(PlayerAction action) {
+        received = action;
+        if (waiting) std::exchange(waiting, nullptr).resume();
+    }
+};
+
+// Задача-сопрограмма боя. Начинает выполняться сразу и идет до первого
+// ожидания ввода; исключение боя передается вызывающему через get().
+class BattleTask {
+public:
+    struct promise_type {
+        std::exception_ptr error;
+
+        BattleTask get_return_object() {
+            return BattleTask(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { error = std::current_exception(); }
+    };
+
+private:
+    std::coroutine_handle<promise_type> handle;
+
+public:
+    explicit BattleTask(std::coroutine_handle<promise_type> h) : handle(h) {}
+    BattleTask(BattleTask&& other) noexcept : handle(std::exchange(other.handle, nullptr)) {}
+    BattleTask& operator=(BattleTask&& other) noexcept {
+        if (this != &other) {
+            if (handle) handle.destroy();
+            handle = std::exchange(other.handle, nullptr);
+        }
+        return *this;
+    }
+    ~BattleTask() { if (handle) handle.destroy(); }
+
+    bool done() const { return handle.done(); }
+
+    // Завершить ожидание результата; бой должен быть закончен
+    void get() const {
+        if (!handle.done()) throw std::logic_error("Бой еще не завершен");
+        if (handle.promise().error) std::rethrow_exception(handle.promise().error);
+    }
+};
+
+class Game {
+private:
+    Character player;
+    Inventory inv;
+    CombatLog log;
+    std::ostream& out; // сообщения боя
+
+    // Использовать зелье лечения
+    void usePotion() {
+        const std::string potion = "Health Potion";
+        if (inv.has(potion)) {
+            player.heal(20, log);
+            inv.remove(potion);
+            out << "Вы использовали зелье. HP = " << player.getHealth() << std::endl;
+        }
+        else {
+            out << "У вас нет зелья!" << std::endl;
+        }
+    }
+
+    // Автобой: оставшиеся ходы (только атаки) вычисляются сразу через
+    // forecastFight, в журнал пишется по итоговому событию на сторону
+    void autoBattle(Monster& m) {
+        FightForecast forecast = forecastFight(player, m);
+        int monsterHits = forecast.playerWins ? forecast.rounds - 1 : forecast.rounds;
+        player.autoAttack(m, forecast.rounds, forecast.monsterHealth, log);
+        m.autoAttack(player, std::max(0, monsterHits), forecast.playerHealth, log);
+        out << "Автобой с " << m.getName() << ", ходов: " << forecast.rounds
+            << ". Ваше HP: " << player.getHealth() << std::endl;
+    }
+
+    // Итог боя: награда за победу или DeathException
+    void finishBattle(const Monster& m) {
+        if (!player.isDead()) {
+            out << "Вы победили " << m.getName() << "!" << std::endl;
+            player.gainExp(50, log);
+            // шанс дропа
+            inv.add("Health Potion");
+            out << "Вы получили Health Potion!" << std::endl;
+            log.flush();
+        }
+        else {
+            log.flush();
+            throw DeathException(player.getName() + " погиб!");
+        }
+    }
+
+public:
+    // Пустое имя logFile отключает текстовый лог; потребителей событий
+    // можно добавить через events()
+    Game(const std::string& name, std::ostream& output = std::cout, const std::string& logFile = "game.log")
+        : player(name, 100, 20, 10), out(output) {
+        if (!logFile.empty()) log.addSink(std::make_unique<TextLogSink>(logFile));
+        player.registerIn(log);
+        // Начальный предмет
+        inv.add("Health Potion");
+    }
+
+    bool isPlayerDead() const { return player.isDead(); }
+    int playerHealth() const { return player.getHealth(); }
+    CombatLog& events() { return log; }
+
+    void start() {
+        out << "=== Добро пожаловать в RPG ===" << std::endl;
+        player.showInfo(out); inv.show(out);
+    }
+
+    // Бой как сопрограмма: ход игрока ожидается через co_await от источника
+    // действий, на время ожидания сопрограмма приостанавливается.
+    // При гибели игрока исключение DeathException сохраняется в задаче.
+    BattleTask playBattle(std::unique_ptr<Monster> m, InputSource& input) {
+        out << "Появился " << m->getName() << "!" << std::endl;
+        m->registerIn(log);
+        while (!player.isDead() && !m->isDead()) {
+            out << "Выберите действие: 1) Атаковать 2) Зелье 3) Автобой\n";
+            PlayerAction choice = co_await nextAction(input,
+                { player.getHealth(), m->getHealth(), inv.has("Health Potion") });
+            if (choice == PlayerAction::AutoBattle) {
+                autoBattle(*m);
+                break;
+            }
+            if (choice == PlayerAction::Potion) {
+                usePotion();
+            }
+            else {
+                player.attackEnemy(*m, log);
+            }
+            if (m->isDead()) break;
+            m->attackEnemy(player, log);
+            out << "Ваше HP: " << player.getHealth() << std::endl;
+        }
+        finishBattle(*m);
+    }
+
+    // Пропуск боя: автобой с первого хода, исход совпадает с playBattle
+    // при одних атаках. Зелья меняют ход боя, поэтому при их использовании
+    // нужен playBattle.
+    void skipBattle(std::unique_ptr<Monster> m) {
+        out << "Появился " << m->getName() << "! Бой пропущен." << std::endl;
+        m->registerIn(log);
+        autoBattle(*m);
+        finishBattle(*m);
+    }
+
+    // Бой с вводом с консоли до завершения
+    void battle(std::unique_ptr<Monster> m) {
+        ConsoleInput console;
+        BattleTask task = playBattle(std::move(m), console);
+        task.get();
+    }
+
+    void save(const std::string& file) {
+        std::ofstream fout(file);
+        player.save(fout);
+        inv.save(fout);
+        out << "Сохранено в " << file << std::endl;
+    }
+    void load(const std::string& file) {
+        std::ifstream fin(file);
+        if (!fin) { std::cerr << "Не удалось загрузить файл" << std::endl; return; }
+        player.load(fin); inv.load(fin);
+        player.registerIn(log);
+        out << "Загружено из " << file << std::endl;
+    }
+};
+
+// Поток вывода без записи: для сессий нагрузочного прогона
+class NullBuffer : public std::streambuf {
+protected:
+    int overflow(int c) override { return c; }
+};
+
+// Нагрузочный прогон: sessions игровых сессий в одном потоке. Каждая
+// сессия ждет действий от QueuedInput; цикл по кругу передает ожидающим
+// сессиям следующее действие сценария, как цикл событий передавал бы
+// пришедшие из сокетов команды. Завершенные сессии начинают новый бой.
+void runLoadTest(size_t sessions, int seconds) {
+    struct Session {
+        std::unique_ptr<Game> game;
+        QueuedInput input;
+        std::optional<BattleTask> task;
+        size_t step = 0;
+    };
+    const PlayerAction script[] = { PlayerAction::Attack, PlayerAction::Attack, PlayerAction::Potion };
+
+    NullBuffer nullBuffer;
+    std::ostream nullOut(&nullBuffer);
+    std::vector<Session> all(sessions);
+    size_t battles = 0, deaths = 0, actions = 0;
+
+    auto startBattle = [&](Session& s, size_t index) {
+        if (!s.game || s.game->isPlayerDead()) s.game = std::make_unique<Game>("Герой", nullOut, "");
+        std::unique_ptr<Monster> monster;
+        if (index % 10 == 9) monster = std::make_unique<Dragon>();
+        else if (index % 3 == 0) monster = std::make_unique<Goblin>();
+        else monster = std::make_unique<Skeleton>();
+        s.task.emplace(s.game->playBattle(std::move(monster), s.input));
+    };
+    for (size_t i = 0; i < sessions; ++i) startBattle(all[i], i);
+
+    auto start = std::chrono::steady_clock::now();
+    auto deadline = start + std::chrono::seconds(seconds);
+    while (std::chrono::steady_clock::now() < deadline) {
+        for (size_t i = 0; i < sessions; ++i) {
+            Session& s = all[i];
+            if (s.input.isWaiting()) {
+                s.input.push(script[s.step++ % 3]);
+                ++actions;
+            }
+            if (s.task->done()) {
+                ++battles;
+                try {
+                    s.task->get();
+                }
+                catch (const DeathException&) {
+                    ++deaths;
+                }
+                startBattle(s, i + battles);
+            }
+        }
+    }
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "Сессий: " << sessions << ", боев завершено: " << battles << ", погибло: " << deaths << "\n"
+        << "Действий в секунду: " << actions / elapsed << "\n";
+}
+
+// Замер пути атаки: форматирование строки на каждом ударе (как раньше),
+// запись двоичных событий без потребителей и удар вовсе без журнала
+void benchmarkCombatEvents() {
+    const int attacks = 10000000;
+    Character hero("Герой", 100, 20, 10);
+    Character goblin("Гоблин", 30, 10, 5);
+    Logger<std::string> disabled("");
+    CombatLog log;
+    hero.registerIn(log);
+    goblin.registerIn(log);
+
+    auto measure = [&](const char* label, auto&& attack) {
+        Character target = goblin;
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < attacks; ++i) {
+            if (target.isDead()) target = goblin;
+            attack(target);
+        }
+        double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / attacks;
+        std::cout << label << ": " << ns << " нс на удар" << std::endl;
+        return ns;
+    };
+
+    std::cout << "=== Журнал боя (" << attacks << " ударов) ===" << std::endl;
+    measure("Строка на каждый удар", [&](Character& target) {
+        int dmg = std::max(1, 15);
+        target.takeDamage(dmg);
+        disabled.log(hero.getName() + " атакует " + target.getName() + " на " + std::to_string(dmg));
+    });
+    measure("Двоичные события без потребителей", [&](Character& target) { hero.attackEnemy(target, log); });
+    measure("Без журнала", [&](Character& target) { target.takeDamage(std::max(1, 15)); });
+}
+
+// Итог боя по журналу: удары каждой стороны (автобой считается своим
+// числом ударов) и HP монстра после последнего удара героя
+class BattleTally : public CombatEventSink {
+private:
+    uint32_t player;
+public:
+    int playerHits = 0, monsterHits = 0, monsterHealth = -1;
+
+    explicit BattleTally(uint32_t playerId) : player(playerId) {}
+    void consume(std::span<const CombatEvent> events, const CombatNames&) override {
+        for (const auto& e : events) {
+            if (e.type != CombatEventType::Attack && e.type != CombatEventType::AutoBattle) continue;
+            int hits = e.type == CombatEventType::Attack ? 1 : e.amount;
+            if (e.actor == player) { playerHits += hits; monsterHealth = e.value; }
+            else monsterHits += hits;
+        }
+    }
+};
+
+// Сверка skipBattle с пошаговым playBattle, в котором игрок только атакует,
+// на сетке характеристик монстра: исход, HP обеих сторон и число ходов.
+// Возвращает число расхождений.
+size_t verifySkipBattle() {
+    NullBuffer nullBuffer;
+    std::ostream nullOut(&nullBuffer);
+    size_t checked = 0, mismatches = 0;
+    auto tally = [](Game& game) {
+        auto sink = std::make_unique<BattleTally>(game.events().actor("Герой"));
+        BattleTally* result = sink.get();
+        game.events().addSink(std::move(sink));
+        return result;
+    };
+    for (int hp = 1; hp <= 300; hp += 7) {
+        for (int atk = 0; atk <= 60; ++atk) {
+            for (int def = 0; def <= 30; def += 2) {
+                Game stepped("Герой", nullOut, ""), skipped("Герой", nullOut, "");
+                BattleTally* steppedTally = tally(stepped);
+                BattleTally* skippedTally = tally(skipped);
+                ScriptedInput attackOnly({});
+                bool steppedDied = false, skippedDied = false;
+                BattleTask task = stepped.playBattle(std::make_unique<Monster>("Монстр", hp, atk, def), attackOnly);
+                try { task.get(); }
+                catch (const DeathException&) { steppedDied = true; }
+                try { skipped.skipBattle(std::make_unique<Monster>("Монстр", hp, atk, def)); }
+                catch (const DeathException&) { skippedDied = true; }
+
+                ++checked;
+                if (steppedDied != skippedDied || stepped.playerHealth() != skipped.playerHealth()
+                    || steppedTally->playerHits != skippedTally->playerHits
+                    || steppedTally->monsterHits != skippedTally->monsterHits
+                    || steppedTally->monsterHealth != skippedTally->monsterHealth) {
+                    if (mismatches++ < 10)
+                        std::cout << "Расхождение: монстр " << hp << "/" << atk << "/" << def << std::endl;
+                }
+            }
+        }
+    }
+    std::cout << "Проверено боев: " << checked << ", расхождений: " << mismatches << std::endl;
+    return mismatches;
+}
+
+int main(int argc, char* argv[]) {
+    setlocale(LC_ALL, "ru");
+    // Сверка пропуска боя с пошаговым боем: --verify-skip
+    if (argc > 1 && std::string(argv[1]) == "--verify-skip") {
+        return verifySkipBattle() == 0 ? 0 : 1;
+    }
+    // Замер записи событий боя: --bench-events
+    if (argc > 1 && std::string(argv[1]) == "--bench-events") {
+        benchmarkCombatEvents();
+        return 0;
+    }
+    // Нагрузочный прогон сессий по сценарию: --load-test [сессий [секунд]]
+    if (argc > 1 && std::string(argv[1]) == "--load-test") {
+        runLoadTest(argc > 2 ? std::stoul(argv[2]) : 10000, argc > 3 ? std::stoi(argv[3]) : 3);
+        return 0;
+    }
+    // Автобой: все бои игры пропускаются, исход вычисляется сразу: --auto
+    if (argc > 1 && std::string(argv[1]) == "--auto") {
+        Game game("Герой");
+        game.start();
+        try {
+            game.skipBattle(std::make_unique<Goblin>());
+            game.skipBattle(std::make_unique<Skeleton>());
+            game.skipBattle(std::make_unique<Dragon>());
+        }
+        catch (const DeathException& e) {
+            std::cerr << e.what() << std::endl;
+        }
+        return 0;
+    }
+    // Бой по сценарию из файла (числа 1, 2 и 3): --script файл
+    if (argc > 2 && std::string(argv[1]) == "--script") {
+        Game game("Герой");
+        game.start();
+        ScriptedInput script = ScriptedInput::fromFile(argv[2]);
+        BattleTask task = game.playBattle(std::make_unique<Skeleton>(), script);
+        try {
+            task.get();
+        }
+        catch (const DeathException& e) {
+            std::cerr << e.what() << std::endl;
+        }
+        return 0;
+    }
+    Game game("Герой");
+    game.start();
+    game.battle(std::make_unique<Goblin>());
+    game.save("save.txt");
+    Game game2("Герой"); game2.load("save.txt"); game2.start();
+    game2.battle(std::make_unique<Skeleton>());
+    try {
+        game2.battle(std::make_unique<Dragon>());
+    }
+    catch (const DeathException& e) {
+        std::cerr << e.what() << std::endl;
+    }
+    return 0;
 }
\ No newline at end of file